@@ -6,9 +6,15 @@
 
 class GDCSize;
 class GDCPoint;
+class GDCPointF;
+class GDCPoints;
+class GDCPath;
 class GDCPaint;
 class wxBitmap;
 
+// curves are flattened up to the quarter of the device pixel
+const float GDC_CURVE_TOLERANCE = 0.25f;
+
 class CAbsGDC
 {
 // Construction/Destruction
@@ -23,17 +29,30 @@ public:
     
     // https://stackoverflow.com/questions/13545792/drawing-a-filled-rectangle-with-a-border-in-android
     // special function to keep current code compatibility
-    virtual void DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) = 0;
-    virtual void DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint)     = 0; // closed line => polygon
-    virtual void DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) = 0;
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) = 0;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)     = 0; // closed line => polygon
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) = 0;
     // special case -> avoid if statements in the general drawings
-    virtual void DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint)                      = 0;
-    virtual void DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) = 0;
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)                      = 0;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) = 0;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) = 0;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude, const wchar_t * sTexturePath, double dAngle, float fZoom) = 0;
 
     virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) = 0;
     virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)            = 0;
+
+    // batches: segments and rectangles are the point pairs
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint)         = 0;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) = 0;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint)        = 0;
+
+    // sub-pixel coordinates
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) = 0;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) = 0;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) = 0;
+
+    // nullptr -> not filled or not stroked
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) = 0;
     
     virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) = 0;
     virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) = 0;
@@ -55,6 +74,9 @@ public:
     virtual void SetViewportOrg(int32_t x, int32_t y) = 0;
     virtual GDCPoint GetViewportOrg() const = 0;
 
+    // max distance (GDC units) of the flattened curve to the exact one, backends with the native curves ignore it
+    virtual void SetCurveTolerance(float fTolerance) = 0;
+
     // sGroupAttrbutes sample: id="bird"
     virtual void BeginGroup(const char *sGroupAttrbutes) = 0; // opengl list or svg group
     virtual void EndGroup() = 0; 
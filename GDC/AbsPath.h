@@ -0,0 +1,15 @@
+#ifndef __ABS_PATH_H__
+#define __ABS_PATH_H__
+#pragma once
+
+// Prepared form of the GDCPath for the one backend (e.g. svg path data, GDI PolyDraw points),
+// built on the first draw and deleted as soon as the path changes.
+class CAbsPath
+{
+// Construction/Destruction
+public:
+    CAbsPath() { }
+    virtual ~CAbsPath() { }
+};
+
+#endif
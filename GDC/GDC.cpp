@@ -4,7 +4,18 @@
 #include "msw/MswGDC.h"
 #include "msw/MswBitmap.h"
 #include "svg/svgGDC.h"
+#include "simplify/SimplifyGDC.h"
+#include "record/RecordGDC.h"
+#include "record/ListPlayer.h"
+#include "record/ListResources.h"
+#include "record/ListFile.h"
+#include "record/ListIndex.h"
+#include "record/ListDiff.h"
 #include "AbsPaint.h"
+#include "AbsPath.h"
+
+#include "algorithm"
+#include "math.h"
 
 #ifdef _DEBUG
     #define new DEBUG_NEW
@@ -142,9 +153,195 @@ int32_t GDCPaint::GetAlfa() const   { return m_nAlfa; }
 COLORREF GDCPaint::GetColor() const { return m_color; }
 COLORREF GDCPaint::GetBkColor() const { return m_bk_color; }
 
+GDCPoint GDCPathArc::GetPoint(float fAngle) const
+{
+    const double dAngle = fAngle * 3.1415926535897932384626433832795 / 180.0;
+    return GDCPoint(m_center.x + (int32_t)::lround(m_nRadius * ::cos(dAngle)),
+                    m_center.y - (int32_t)::lround(m_nRadius * ::sin(dAngle)));
+}
+
+GDCPath::GDCPath(const GDCPath &path)
+{
+    *this = path;
+}
+
+GDCPath::~GDCPath()
+{
+    ResetCache();
+}
+
+GDCPath &GDCPath::operator=(const GDCPath &path)
+{
+    if ( this == &path ) {
+        return *this;
+    }
+    ResetCache(); // prepared forms are not shared
+    m_verbs = path.m_verbs;
+    m_points.clear();
+    m_points.insert(m_points.end(), path.m_points.begin(), path.m_points.end());
+    m_arcs.clear();
+    m_arcs.insert(m_arcs.end(), path.m_arcs.begin(), path.m_arcs.end());
+    m_fill_rule = path.m_fill_rule;
+    return *this;
+}
+
+void GDCPath::ResetCache()
+{
+    delete m_pSvgPath;
+    m_pSvgPath = nullptr;
+    delete m_pMswPath;
+    m_pMswPath = nullptr;
+}
+
+void GDCPath::MoveTo(int32_t x, int32_t y)
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_MOVE);
+    m_points.emplace_back(x, y);
+}
+
+void GDCPath::LineTo(int32_t x, int32_t y)
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_LINE);
+    m_points.emplace_back(x, y);
+}
+
+void GDCPath::Arc(int32_t x, int32_t y, int32_t nRadius, float fStartAngle, float fSweepAngle)
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_ARC);
+    m_arcs.emplace_back();
+    GDCPathArc &arc = m_arcs.back();
+    arc.m_center.x    = x;
+    arc.m_center.y    = y;
+    arc.m_nRadius     = nRadius;
+    arc.m_fStartAngle = fStartAngle;
+    arc.m_fSweepAngle = fSweepAngle;
+}
+
+void GDCPath::QuadTo(int32_t x1, int32_t y1, int32_t x, int32_t y)
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_QUAD);
+    m_points.emplace_back(x1, y1);
+    m_points.emplace_back(x, y);
+}
+
+void GDCPath::CubicTo(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x, int32_t y)
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_CUBIC);
+    m_points.emplace_back(x1, y1);
+    m_points.emplace_back(x2, y2);
+    m_points.emplace_back(x, y);
+}
+
+bool GDCPath::HasCurves() const
+{
+    return std::any_of(m_verbs.begin(), m_verbs.end(), [](uint8_t verb) {
+        return verb == GDC_PATH_QUAD || verb == GDC_PATH_CUBIC;
+    });
+}
+
+void GDCPath::Close()
+{
+    ResetCache();
+    m_verbs.push_back(GDC_PATH_CLOSE);
+}
+
+void GDCPath::Clear()
+{
+    ResetCache();
+    m_verbs.clear();
+    m_points.clear();
+    m_arcs.clear();
+}
+
+bool GDCPath::GetBounds(RECT &rect) const
+{
+    if ( m_points.empty() && m_arcs.empty() ) {
+        return false;
+    }
+    rect.left = rect.top     = INT32_MAX;
+    rect.right = rect.bottom = INT32_MIN;
+    for (const GDCPoint &pt : m_points) {
+        rect.left   = (std::min)(rect.left,   (LONG)pt.x);
+        rect.right  = (std::max)(rect.right,  (LONG)pt.x);
+        rect.top    = (std::min)(rect.top,    (LONG)pt.y);
+        rect.bottom = (std::max)(rect.bottom, (LONG)pt.y);
+    }
+    for (const GDCPathArc &arc : m_arcs) {
+        rect.left   = (std::min)(rect.left,   (LONG)(arc.m_center.x - arc.m_nRadius));
+        rect.right  = (std::max)(rect.right,  (LONG)(arc.m_center.x + arc.m_nRadius));
+        rect.top    = (std::min)(rect.top,    (LONG)(arc.m_center.y - arc.m_nRadius));
+        rect.bottom = (std::max)(rect.bottom, (LONG)(arc.m_center.y + arc.m_nRadius));
+    }
+    return true;
+}
+
+namespace internal
+{
+    // deviation of the curve from the chords is up to the dDiff * k / n^2 (dDiff - largest second difference)
+    static inline int32_t GetFlattenCount(double dDiff, double k, double dTolerance)
+    {
+        const int32_t nMaxCount = 1024;
+        if ( dTolerance <= 0. ) {
+            return nMaxCount;
+        }
+        const double dCount = ::ceil(::sqrt(dDiff * k / dTolerance));
+        return (int32_t)(std::max)(1., (std::min)((double)nMaxCount, dCount));
+    }
+
+    static inline void AddFlattenPoint(double x, double y, std::vector<GDCPoint> &points)
+    {
+        const int32_t nX = (int32_t)::lround(x);
+        const int32_t nY = (int32_t)::lround(y);
+        if ( !points.empty() && points.back().x == nX && points.back().y == nY ) {
+            return;
+        }
+        points.emplace_back(nX, nY);
+    }
+};
+
+void FlattenGdcQuad(const GDCPoint &pt0, const GDCPoint &pt1, const GDCPoint &pt2, double dTolerance, std::vector<GDCPoint> &points)
+{
+    const double ddx = pt0.x - 2. * pt1.x + pt2.x;
+    const double ddy = pt0.y - 2. * pt1.y + pt2.y;
+    const int32_t nCount = internal::GetFlattenCount(::sqrt(ddx * ddx + ddy * ddy), 0.25, dTolerance);
+    for (int32_t i = 1; i < nCount; ++i) {
+        const double t  = (double)i / nCount;
+        const double mt = 1. - t;
+        internal::AddFlattenPoint(mt * mt * pt0.x + 2. * mt * t * pt1.x + t * t * pt2.x,
+                                  mt * mt * pt0.y + 2. * mt * t * pt1.y + t * t * pt2.y, points);
+    }
+    points.emplace_back(pt2.x, pt2.y);
+}
+
+void FlattenGdcCubic(const GDCPoint &pt0, const GDCPoint &pt1, const GDCPoint &pt2, const GDCPoint &pt3, double dTolerance, std::vector<GDCPoint> &points)
+{
+    const double ddx1 = pt0.x - 2. * pt1.x + pt2.x;
+    const double ddy1 = pt0.y - 2. * pt1.y + pt2.y;
+    const double ddx2 = pt1.x - 2. * pt2.x + pt3.x;
+    const double ddy2 = pt1.y - 2. * pt2.y + pt3.y;
+    const double dDiff = ::sqrt((std::max)(ddx1 * ddx1 + ddy1 * ddy1, ddx2 * ddx2 + ddy2 * ddy2));
+    const int32_t nCount = internal::GetFlattenCount(dDiff, 0.75, dTolerance);
+    for (int32_t i = 1; i < nCount; ++i) {
+        const double t  = (double)i / nCount;
+        const double mt = 1. - t;
+        const double a  = mt * mt * mt;
+        const double b  = 3. * mt * mt * t;
+        const double c  = 3. * mt * t * t;
+        const double d  = t * t * t;
+        internal::AddFlattenPoint(a * pt0.x + b * pt1.x + c * pt2.x + d * pt3.x,
+                                  a * pt0.y + b * pt1.y + c * pt2.y + d * pt3.y, points);
+    }
+    points.emplace_back(pt3.x, pt3.y);
+}
+
 GDC::GDC(HDC hDC)
 {
-    m_pDC = new CMswGDC(hDC);
+    m_pDC = m_pBackend = new CMswGDC(hDC);
 }
 
 GDC::~GDC()
@@ -152,38 +349,250 @@ GDC::~GDC()
     delete m_pDC;
 }
 
+enum GDCLodAction
+{
+    GDC_LOD_DRAW,
+    GDC_LOD_DROP,
+    GDC_LOD_COLLAPSE
+};
+
+static GDCLodAction GetLodAction(const GDCLodPolicy &lod, float fScale, const GDCPoints &points, RECT &rect)
+{
+    if ( points.empty() ) {
+        return GDC_LOD_DRAW;
+    }
+    rect.left  = rect.right  = points[0].x;
+    rect.top   = rect.bottom = points[0].y;
+    for (const GDCPoint pt : points) {
+        rect.left   = (std::min)(rect.left,   (LONG)pt.x);
+        rect.right  = (std::max)(rect.right,  (LONG)pt.x);
+        rect.top    = (std::min)(rect.top,    (LONG)pt.y);
+        rect.bottom = (std::max)(rect.bottom, (LONG)pt.y);
+    }
+    const float fSize = (std::max)(rect.right - rect.left, rect.bottom - rect.top) * fScale;
+    if ( fSize < lod.m_fDropSize ) {
+        return GDC_LOD_DROP;
+    }
+    if ( fSize < lod.m_fCollapseSize && points.size() > 4 ) {
+        return GDC_LOD_COLLAPSE;
+    }
+    return GDC_LOD_DRAW;
+}
+
+void GDC::SetDeviceScale(float fScale)
+{
+    if ( !(fScale > 0.f) ) { // NaN too
+        ASSERT(FALSE);
+        return;
+    }
+    m_fDeviceScale = fScale;
+    m_pDC->SetCurveTolerance(GDC_CURVE_TOLERANCE / m_fDeviceScale);
+    if ( m_pSimplify ) {
+        m_pSimplify->SetMode(m_simplify_mode, m_fSimplifyTolerance / m_fDeviceScale);
+    }
+}
+
+void GDC::SetSimplify(GDCSimplifyMode mode, float fTolerance)
+{
+    m_simplify_mode      = mode;
+    m_fSimplifyTolerance = fTolerance;
+    if ( !m_pSimplify ) {
+        if ( mode == GDC_SIMPLIFY_NONE ) {
+            return;
+        }
+        m_pSimplify = new CSimplifyGDC(m_pDC);
+        m_pDC = m_pSimplify;
+    }
+    m_pSimplify->SetMode(m_simplify_mode, m_fSimplifyTolerance / m_fDeviceScale);
+}
+
+void GDC::SetLodPolicy(const GDCLodPolicy &policy)
+{
+    m_lod  = policy;
+    m_bLod = m_lod.m_fDropSize > 0.f || m_lod.m_fCollapseSize > 0.f || m_lod.m_fMinTextHeight > 0.f;
+}
+
+bool GDC::IsLodDropped(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    const float fSize = (std::max)(::abs(x2 - x1), ::abs(y2 - y1)) * m_fDeviceScale;
+    if ( fSize < m_lod.m_fDropSize ) {
+        ++m_lod_stats.m_nDropped;
+        return true;
+    }
+    return false;
+}
+
+bool GDC::IsTextSkipped(const GDCPaint &paint)
+{
+    const GDCFontDescr *pFont = paint.GetFontDescr();
+    if ( pFont && ::abs(pFont->m_nHeight) * m_fDeviceScale < m_lod.m_fMinTextHeight ) {
+        ++m_lod_stats.m_nTextSkipped;
+        return true;
+    }
+    return false;
+}
+
 void GDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
+    if ( m_bLod && IsLodDropped(x1, y1, x2, y2) ) {
+        return;
+    }
     m_pDC->DrawLine(x1, y1, x2, y2, paint);
 }
 
-void GDC::DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+namespace internal
+{
+    static inline void GetBoundsF(const GDCPointF *pPoints, size_t nCount, RECT &rect)
+    {
+        float fMinX = pPoints[0].x;
+        float fMinY = pPoints[0].y;
+        float fMaxX = fMinX;
+        float fMaxY = fMinY;
+        for (size_t i = 1; i < nCount; ++i) {
+            fMinX = (std::min)(fMinX, pPoints[i].x);
+            fMinY = (std::min)(fMinY, pPoints[i].y);
+            fMaxX = (std::max)(fMaxX, pPoints[i].x);
+            fMaxY = (std::max)(fMaxY, pPoints[i].y);
+        }
+        // clamped: int32_t sizes are computed without the overflow
+        const float fLimit = 1073741824.f;
+        rect.left   = (LONG)::floor((std::max)(-fLimit, fMinX));
+        rect.top    = (LONG)::floor((std::max)(-fLimit, fMinY));
+        rect.right  = (LONG)::ceil((std::min)(fLimit, fMaxX));
+        rect.bottom = (LONG)::ceil((std::min)(fLimit, fMaxY));
+    }
+};
+
+void GDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    if ( m_bLod ) {
+        const GDCPointF points[2] = { GDCPointF(x1, y1), GDCPointF(x2, y2) };
+        RECT rect;
+        internal::GetBoundsF(points, 2, rect);
+        if ( IsLodDropped(rect.left, rect.top, rect.right, rect.bottom) ) {
+            return;
+        }
+    }
+    m_pDC->DrawLineF(x1, y1, x2, y2, paint);
+}
+
+void GDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    if ( nCount == 0 ) {
+        return;
+    }
+    if ( m_bLod ) {
+        RECT rect;
+        internal::GetBoundsF(pPoints, nCount, rect);
+        if ( IsLodDropped(rect.left, rect.top, rect.right, rect.bottom) ) {
+            return;
+        }
+    }
+    m_pDC->DrawPolyLineF(pPoints, nCount, stroke_paint);
+}
+
+void GDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    if ( nCount == 0 ) {
+        return;
+    }
+    if ( m_bLod ) {
+        RECT rect;
+        internal::GetBoundsF(pPoints, nCount, rect);
+        if ( IsLodDropped(rect.left, rect.top, rect.right, rect.bottom) ) {
+            return;
+        }
+    }
+    m_pDC->DrawPolygonF(pPoints, nCount, fill_paint, stroke_paint);
+}
+
+void GDC::DrawPolygon(const GDCPoints &src_points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
 {
+    if ( m_bCleanup && !::CleanGdcPoly(src_points, m_clean, true, &m_clean_stats) ) {
+        if ( m_clean.size() > 1 ) {
+            m_pDC->DrawPoly(m_clean, stroke_paint); // nothing to fill, outline only
+        }
+        return;
+    }
+    const GDCPoints points = m_bCleanup ? m_clean : src_points;
+    if ( m_bLod ) {
+        RECT rect;
+        switch ( ::GetLodAction(m_lod, m_fDeviceScale, points, rect) )
+        {
+        case GDC_LOD_DROP:
+            ++m_lod_stats.m_nDropped;
+            return;
+        case GDC_LOD_COLLAPSE:
+            ++m_lod_stats.m_nCollapsed;
+            m_lod_rect.clear(); // capacity is reused
+            m_lod_rect.emplace_back(rect.left,  rect.top);
+            m_lod_rect.emplace_back(rect.right, rect.top);
+            m_lod_rect.emplace_back(rect.right, rect.bottom);
+            m_lod_rect.emplace_back(rect.left,  rect.bottom);
+            m_pDC->DrawPolygon(m_lod_rect, fill_paint, stroke_paint);
+            return;
+        default:
+            break;
+        }
+    }
     m_pDC->DrawPolygon(points, fill_paint, stroke_paint);
 }
 
-void GDC::DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint)
+void GDC::DrawPoly(const GDCPoints &src_points, const GDCPaint &stroke_paint)
 {
-    const size_t cnt = points.size();
-    if ( cnt < 2 ) {
+    if ( src_points.size() < 2 ) {
         return; // expected at least 3 points
     }
+    if ( m_bCleanup ) {
+        ::CleanGdcPoly(src_points, m_clean, true, &m_clean_stats); // outline is drawn without area too
+    }
+    const GDCPoints points = m_bCleanup && m_clean.size() > 1 ? m_clean : src_points;
+    if ( m_bLod ) {
+        RECT rect;
+        switch ( ::GetLodAction(m_lod, m_fDeviceScale, points, rect) )
+        {
+        case GDC_LOD_DROP:
+            ++m_lod_stats.m_nDropped;
+            return;
+        case GDC_LOD_COLLAPSE:
+            ++m_lod_stats.m_nCollapsed;
+            m_pDC->DrawRectangle(rect.left, rect.top, rect.right, rect.bottom, stroke_paint);
+            return;
+        default:
+            break;
+        }
+    }
     m_pDC->DrawPoly(points, stroke_paint);
 }
 
-void GDC::DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint)
+void GDC::DrawPolygonTransparent(const GDCPoints &src_points, const GDCPaint &fill_paint)
 {
-    m_pDC->DrawPolygonTransparent(points, fill_paint);
+    if ( m_bCleanup && !::CleanGdcPoly(src_points, m_clean, true, &m_clean_stats) ) {
+        return;
+    }
+    m_pDC->DrawPolygonTransparent(m_bCleanup ? m_clean : src_points, fill_paint);
 }
 
-void GDC::DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
+void GDC::DrawPolygonGradient(const GDCPoints &src_points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
 {
+    if ( m_bCleanup && !::CleanGdcPoly(src_points, m_clean, true, &m_clean_stats) ) {
+        return;
+    }
+    const GDCPoints points = m_bCleanup ? m_clean : src_points;
+    RECT rect;
+    if ( m_bLod && ::GetLodAction(m_lod, m_fDeviceScale, points, rect) == GDC_LOD_DROP ) {
+        ++m_lod_stats.m_nDropped;
+        return;
+    }
     m_pDC->DrawPolygonGradient(points, paintFrom, paintTo);
 }
 
-void GDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom)
+void GDC::DrawPolygonTexture(const std::vector<GDCPoint> &src_points, const wchar_t * sTexturePath, double dAngle, float fZoom)
 {
-    m_pDC->DrawPolygonTexture(points, sTexturePath, dAngle, fZoom);
+    if ( m_bCleanup && !::CleanGdcPoly(src_points, m_clean, true, &m_clean_stats) ) {
+        return;
+    }
+    m_pDC->DrawPolygonTexture(m_bCleanup ? m_clean : src_points, sTexturePath, dAngle, fZoom);
 }
 
 void GDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude, 
@@ -192,8 +601,29 @@ void GDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vec
     m_pDC->DrawPolygonTexture(points, points_exclude, sTexturePath, dAngle, fZoom);
 }
 
-void GDC::DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint)
+void GDC::DrawPolyLine(const GDCPoints &src_points, const GDCPaint &stroke_paint)
 {
+    if ( m_bCleanup ) {
+        ::CleanGdcPoly(src_points, m_clean, false, &m_clean_stats);
+    }
+    // single point line is passed as is (caps)
+    const GDCPoints points = m_bCleanup && m_clean.size() > 1 ? m_clean : src_points;
+    if ( m_bLod ) {
+        RECT rect;
+        switch ( ::GetLodAction(m_lod, m_fDeviceScale, points, rect) )
+        {
+        case GDC_LOD_DROP:
+            ++m_lod_stats.m_nDropped;
+            return;
+        case GDC_LOD_COLLAPSE:
+            ++m_lod_stats.m_nCollapsed;
+            // end points of the closed or folded line are close -> diagonal of the bounds keeps the extent
+            m_pDC->DrawLine(rect.left, rect.top, rect.right, rect.bottom, stroke_paint);
+            return;
+        default:
+            break;
+        }
+    }
     m_pDC->DrawPolyLine(points, stroke_paint);
 }
 
@@ -204,21 +634,100 @@ void GDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint)
 
 void GDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint)
 {
+    if ( m_bLod && IsLodDropped(x1, y1, x2, y2) ) {
+        return;
+    }
     m_pDC->DrawFilledRectangle(x1, y1, x2, y2, fill_paint);
 }
 
 void GDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint)
 {
+    if ( m_bLod && IsLodDropped(x1, y1, x2, y2) ) {
+        return;
+    }
     m_pDC->DrawRectangle(x1, y1, x2, y2, stroke_paint);
 }
 
+void GDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    if ( points.size() < 2 ) {
+        return;
+    }
+    m_pDC->DrawLines(points, paint);
+}
+
+void GDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    if ( corners.size() < 2 ) {
+        return;
+    }
+    m_pDC->DrawRects(corners, stroke_paint);
+}
+
+void GDC::DrawRectsOnPoints(const GDCPoints &points, int32_t nSize, const GDCPaint &stroke_paint)
+{
+    m_batch.clear(); // capacity is reused
+    for (const GDCPoint pt : points) {
+        m_batch.emplace_back(pt.x - nSize, pt.y - nSize);
+        m_batch.emplace_back(pt.x + nSize, pt.y + nSize);
+    }
+    DrawRects(m_batch, stroke_paint);
+}
+
+void GDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    if ( points.empty() ) {
+        return;
+    }
+    m_pDC->DrawPoints(points, paint);
+}
+
+bool GDC::IsPathDropped(const GDCPath &path)
+{
+    if ( path.IsEmpty() ) {
+        return true;
+    }
+    RECT rect;
+    return m_bLod && path.GetBounds(rect) && IsLodDropped(rect.left, rect.top, rect.right, rect.bottom);
+}
+
+void GDC::DrawPath(const GDCPath &path, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    if ( IsPathDropped(path) ) {
+        return;
+    }
+    m_pDC->DrawPath(path, &fill_paint, &stroke_paint);
+}
+
+void GDC::DrawPath(const GDCPath &path, const GDCPaint &stroke_paint)
+{
+    if ( IsPathDropped(path) ) {
+        return;
+    }
+    m_pDC->DrawPath(path, nullptr, &stroke_paint);
+}
+
+void GDC::FillPath(const GDCPath &path, const GDCPaint &fill_paint)
+{
+    if ( IsPathDropped(path) ) {
+        return;
+    }
+    m_pDC->DrawPath(path, &fill_paint, nullptr);
+}
+
 void GDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
+    if ( m_bLod && IsLodDropped(x1, y1, x2, y2) ) {
+        return;
+    }
     m_pDC->DrawEllipse(x1, y1, x2, y2, paint);
 }
 
 void GDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
+    if ( m_bLod && IsLodDropped(x1, y1, x2, y2) ) {
+        return;
+    }
     m_pDC->DrawFilledEllipse(x1, y1, x2, y2, paint);
 }
 
@@ -231,16 +740,25 @@ void GDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t r
 void GDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, 
                   const float fStartAngle, const float fSweepAngle, const GDCPaint &paint)
 {
+    if ( m_bLod && IsLodDropped(x - nRadius, y - nRadius, x + nRadius, y + nRadius) ) {
+        return;
+    }
     m_pDC->DrawArc(x, y, nRadius, fStartAngle, fSweepAngle, paint);
 }
 
 void GDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint)
 {
+    if ( m_bLod && IsTextSkipped(paint) ) {
+        return;
+    }
     m_pDC->TextOut(sText, x, y, paint);
 }
 
 void GDC::TextOutRect(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
 {
+    if ( m_bLod && IsTextSkipped(paint) ) {
+        return;
+    }
     const GDCSize sz = GetTextExtent(sText, ::wcslen(sText), paint);
     const int32_t center_x = int32_t((rect.left   + rect.right)*0.5);
     const int32_t center_y = int32_t((rect.bottom + rect.top)*0.5);
@@ -254,18 +772,27 @@ void GDC::TextOutRect(const wchar_t *sText, const RECT &rect, const GDCPaint &pa
 
 void GDC::DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
 {
+    if ( m_bLod && IsTextSkipped(paint) ) {
+        return;
+    }
     m_pDC->DrawText(sText, rect, paint);
 }
 
 void GDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter, 
                             const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint)
 {
+    if ( m_bLod && IsTextSkipped(paint) ) {
+        return;
+    }
     m_pDC->DrawTextByEllipse(dCenterAngle, nRadiusX, nRadiusY, xCenter, yCenter, sText, dEllipseAngleRad, paint);
 }
 
 void GDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText, 
                            bool bRevertTextDir, const GDCPaint &paint)
 {
+    if ( m_bLod && IsTextSkipped(paint) ) {
+        return;
+    }
     m_pDC->DrawTextByCircle(dCenterAngle, nRadius, nCX, nCY, sText, bRevertTextDir, paint);
 }
 
@@ -341,22 +868,210 @@ int32_t GDCBitmap::Height() const
 
 GDC::GDC(GDCBitmap &bitmap, COLORREF background /* = RGB(255, 255, 255) */)
 {
-    m_pDC = new CMswGDC(bitmap, background);
+    m_pDC = m_pBackend = new CMswGDC(bitmap, background);
 }
 
 GDC::GDC(HWND hwnd)
 {
-    m_pDC = new CMswGDC(hwnd);
+    m_pDC = m_pBackend = new CMswGDC(hwnd);
 }
 
 GDC::GDC(GDCSvg &svg)
 {
-    if ( svg.m_pBuffer ) {
-        m_pDC = new SvgGDC(svg.m_pBuffer, svg.Width(), svg.Height(), svg.m_bAutoSize, svg.m_sPrefix.c_str());
+    m_pDC = m_pBackend = new SvgGDC(svg);
+}
+
+GDC::GDC(GDCDisplayList &list)
+{
+    m_pDC = m_pBackend = new CRecordGDC(list);
+}
+
+void GDC::Replay(const GDCDisplayList &list)
+{
+    CListSections sections;
+    list.GetSections(sections);
+    CListPlayer player(list.GetResources());
+    player.Replay(sections, m_pBackend);
+}
+
+void GDC::Replay(const GDCDisplayFile &file)
+{
+    ASSERT(file.IsOpen());
+    if ( !file.IsOpen() ) {
+        return;
+    }
+    CListPlayer player(file.m_pFile->GetResources());
+    player.Replay(file.m_pFile->GetSections(), m_pBackend);
+}
+
+void GDC::ReplayGroup(const GDCDisplayList &list, size_t iGroup)
+{
+    CListSections sections;
+    list.GetSections(sections);
+    CListPlayer player(list.GetResources());
+    player.ReplayGroup(sections, iGroup, m_pBackend);
+}
+
+void GDC::ReplayGroup(const GDCDisplayFile &file, size_t iGroup)
+{
+    ASSERT(file.IsOpen());
+    if ( !file.IsOpen() ) {
+        return;
+    }
+    CListPlayer player(file.m_pFile->GetResources());
+    player.ReplayGroup(file.m_pFile->GetSections(), iGroup, m_pBackend);
+}
+
+void GDC::ReplayRegion(const GDCDisplayList &list, const RECT &rect)
+{
+    CListSections sections;
+    list.GetSections(sections);
+    CListPlayer player(list.GetResources());
+    player.ReplayRegion(sections, rect, m_pBackend);
+}
+
+void GDC::ReplayRegion(const GDCDisplayFile &file, const RECT &rect)
+{
+    ASSERT(file.IsOpen());
+    if ( !file.IsOpen() ) {
+        return;
+    }
+    CListPlayer player(file.m_pFile->GetResources());
+    player.ReplayRegion(file.m_pFile->GetSections(), rect, m_pBackend);
+}
+
+GDCDisplayList::~GDCDisplayList()
+{
+    delete m_pResources;
+    delete m_pIndex;
+}
+
+void GDCDisplayList::GetSections(CListSections &sections) const
+{
+    sections.m_pDefs         = m_defs.data();
+    sections.m_nDefsSize     = m_defs.size();
+    sections.m_pCommands     = m_data.data();
+    sections.m_nCommandsSize = m_data.size();
+    sections.m_pGroups       = m_groups.data();
+    sections.m_nGroups       = m_groups.size();
+    if ( m_pIndex ) {
+        m_pIndex->GetView(sections.m_index);
+    }
+}
+
+CListResources &GDCDisplayList::GetResources() const
+{
+    if ( !m_pResources ) {
+        m_pResources = new CListResources;
+    }
+    return *m_pResources;
+}
+
+bool GDCDisplayList::Save(const wchar_t *sFilePath) const
+{
+    if ( m_nBitmaps > 0 ) {
+        ASSERT(FALSE); // handles can not be saved
+        return false;
+    }
+    CListSections sections;
+    GetSections(sections);
+    return CListFile::Write(sFilePath, sections, m_nCommands);
+}
+
+bool GDCDisplayList::HitTest(int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit) const
+{
+    CListSections sections;
+    GetSections(sections);
+    CListPlayer player(GetResources());
+    return player.HitTest(sections, x, y, nTolerance, hit);
+}
+
+void GDCDisplayList::Diff(const GDCDisplayList &previous, size_t nMaxRects, std::vector<RECT> &dirty) const
+{
+    CListSections old_sections;
+    previous.GetSections(old_sections);
+    CListPlayer old_player(previous.GetResources());
+    CListSections new_sections;
+    GetSections(new_sections);
+    CListPlayer new_player(GetResources());
+
+    CListDiff diff;
+    diff.Diff(old_sections.m_index, old_player.GetDigest(old_sections), new_sections.m_index, new_player.GetDigest(new_sections),
+              nMaxRects, dirty);
+}
+
+void GDCDisplayList::Clear()
+{
+    m_data.clear();
+    m_defs.clear();
+    m_groups.clear();
+    m_nCommands = 0;
+    m_nPaints   = 0;
+    m_nPaths    = 0;
+    m_nBitmaps  = 0;
+    m_last.x    = 0;
+    m_last.y    = 0;
+    delete m_pResources;
+    m_pResources = nullptr;
+    delete m_pIndex;
+    m_pIndex = nullptr;
+}
+
+GDCDisplayFile::~GDCDisplayFile()
+{
+    delete m_pFile;
+}
+
+bool GDCDisplayFile::Open(const wchar_t *sFilePath)
+{
+    Close();
+    CListFile *pFile = new CListFile;
+    if ( !pFile->Open(sFilePath) ) {
+        delete pFile;
+        return false;
+    }
+    m_pFile = pFile;
+    return true;
+}
+
+void GDCDisplayFile::Close()
+{
+    delete m_pFile;
+    m_pFile = nullptr;
+}
+
+size_t GDCDisplayFile::GetCommandCount() const
+{
+    return m_pFile ? m_pFile->GetCommandCount() : 0;
+}
+
+size_t GDCDisplayFile::GetGroupCount() const
+{
+    return m_pFile ? m_pFile->GetSections().m_nGroups : 0;
+}
+
+const GDCListGroup *GDCDisplayFile::GetGroup(size_t iGroup) const
+{
+    if ( !m_pFile || iGroup >= m_pFile->GetSections().m_nGroups ) {
+        ASSERT(FALSE);
+        return nullptr;
     }
-    else {
-        m_pDC = new SvgGDC(svg.GetFilePath(), svg.Width(), svg.Height(), svg.m_bAutoSize, svg.m_sPrefix.c_str());
+    return m_pFile->GetSections().m_pGroups + iGroup;
+}
+
+std::string GDCDisplayFile::GetGroupAttributes(size_t iGroup) const
+{
+    return m_pFile ? m_pFile->GetGroupAttributes(iGroup) : std::string();
+}
+
+bool GDCDisplayFile::HitTest(int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit) const
+{
+    ASSERT(m_pFile);
+    if ( !m_pFile ) {
+        return false;
     }
+    CListPlayer player(m_pFile->GetResources());
+    return player.HitTest(m_pFile->GetSections(), x, y, nTolerance, hit);
 }
 
 GDCSvg::GDCSvg(std::string *pBuffer, int32_t width, int32_t height, bool bAutoSize)
@@ -384,4 +1099,45 @@ GDCSvg::~GDCSvg()
 void GDCSvg::SetPrefix(const char *sPrefix)
 {
     m_sPrefix = sPrefix;
+}
+
+void GDCSvg::SetFileBlockSize(size_t nBlockSize)
+{
+    m_nFileBlockSize = nBlockSize;
+}
+
+void GDCSvg::SetAsyncWrite(bool bAsync)
+{
+    m_bAsyncWrite = bAsync;
+}
+
+void GDCSvg::SetCompression(int32_t nLevel)
+{
+    m_nCompression = nLevel;
+}
+
+void GDCSvg::SetStyleClasses(bool bStyleClasses)
+{
+    m_bStyleClasses = bStyleClasses;
+}
+
+void GDCSvg::SetDeferredHeader(bool bDeferred, bool bFitViewBox)
+{
+    m_bDeferredHeader = bDeferred;
+    m_bFitViewBox     = bDeferred && bFitViewBox;
+}
+
+void GDCSvg::SetMergeLines(bool bMergeLines)
+{
+    m_bMergeLines = bMergeLines;
+}
+
+void GDCSvg::SetInstancing(bool bInstancing)
+{
+    m_bInstancing = bInstancing;
+}
+
+void GDCSvg::SetCulling(bool bCulling)
+{
+    m_bCulling = bCulling;
 }
\ No newline at end of file
@@ -85,6 +85,13 @@ enum GDCBackgroundMode
     GDC_OPAQUE      = 2
 };
 
+enum GDCSimplifyMode
+{
+    GDC_SIMPLIFY_NONE            = 0,
+    GDC_SIMPLIFY_DOUGLAS_PEUCKER = 1,
+    GDC_SIMPLIFY_VISVALINGAM     = 2
+};
+
 #include "string"
 
 class wxBitmap;
@@ -195,8 +202,23 @@ public:
 
 // Attributes
 public:
-    int32_t x {0}; // maybe float or double ?
-    int32_t y {0}; // maybe float or double ?
+    int32_t x {0}; // sub-pixel coordinates: GDCPointF
+    int32_t y {0};
+};
+
+// Sub-pixel point: svg gets the bounded precision decimals, raster backends draw it anti-aliased
+class GDCPointF final
+{
+// Construction/Destruction
+public:
+    GDCPointF() { }
+    GDCPointF(float src_x, float src_y) : x(src_x), y(src_y) { }
+    ~GDCPointF() { }
+
+// Attributes
+public:
+    float x {0.f};
+    float y {0.f};
 };
 
 class GDCSize final
@@ -214,6 +236,78 @@ public:
 };
 
 #include "vector"
+#include "type_traits"
+
+// Non owning view of the points: GDCPoint array, std::vector<GDCPoint> or
+// the array of the user structs with the 32 bit x, y members (GDCPoints::Strided).
+// Data must stay valid while the view is used.
+class GDCPoints final
+{
+// Construction/Destruction
+public:
+    GDCPoints() { }
+    GDCPoints(const std::vector<GDCPoint> &points) : GDCPoints(points.data(), points.size()) { }
+    GDCPoints(const GDCPoint *pPoints, size_t nCount)
+        : GDCPoints(pPoints ? &pPoints->x : nullptr, pPoints ? &pPoints->y : nullptr, nCount, sizeof(GDCPoint)) { }
+    // nStride: bytes between the consecutive points
+    GDCPoints(const int32_t *pX, const int32_t *pY, size_t nCount, size_t nStride)
+        : m_pX((const char *)pX), m_pY((const char *)pY), m_nCount(nCount), m_nStride(nStride) { }
+    ~GDCPoints() { }
+
+    template <class TPoint>
+    static GDCPoints Strided(const TPoint *pPoints, size_t nCount) {
+        static_assert(std::is_integral<decltype(pPoints->x)>::value && sizeof(pPoints->x) == sizeof(int32_t) &&
+                      std::is_integral<decltype(pPoints->y)>::value && sizeof(pPoints->y) == sizeof(int32_t), "32 bit x, y expected");
+        return GDCPoints(pPoints ? (const int32_t *)&pPoints->x : nullptr, pPoints ? (const int32_t *)&pPoints->y : nullptr, nCount, sizeof(TPoint));
+    }
+    template <class TPoint>
+    static GDCPoints Strided(const std::vector<TPoint> &points) {
+        return Strided(points.data(), points.size());
+    }
+    // rectangles as the corner pairs: left, top and right, bottom (RECT layout)
+    template <class TRect>
+    static GDCPoints Corners(const TRect *pRects, size_t nCount) {
+        static_assert(sizeof(TRect) == 4 * sizeof(int32_t), "left, top, right, bottom expected");
+        return GDCPoints(pRects ? (const int32_t *)&pRects->left : nullptr, pRects ? (const int32_t *)&pRects->top : nullptr,
+                         2 * nCount, 2 * sizeof(int32_t));
+    }
+
+// Operations
+public:
+    size_t size() const { return m_nCount; }
+    bool empty() const  { return m_nCount == 0; }
+
+    int32_t X(size_t i) const { return *(const int32_t *)(m_pX + i * m_nStride); }
+    int32_t Y(size_t i) const { return *(const int32_t *)(m_pY + i * m_nStride); }
+    GDCPoint operator[](size_t i) const { return GDCPoint(X(i), Y(i)); }
+    GDCPoint front() const { return (*this)[0]; }
+    GDCPoint back() const  { return (*this)[m_nCount - 1]; }
+
+    // x, y pairs without gaps (GDCPoint, POINT layout) -> can be passed to the platform API as is
+    bool IsPacked() const { return m_nStride == 2 * sizeof(int32_t) && m_pY == m_pX + sizeof(int32_t); }
+    const int32_t *PackedData() const { return (const int32_t *)m_pX; }
+
+    class const_iterator
+    {
+    public:
+        const_iterator(const GDCPoints *pPoints, size_t i) : m_pPoints(pPoints), m_i(i) { }
+        GDCPoint operator*() const { return (*m_pPoints)[m_i]; }
+        const_iterator &operator++() { ++m_i; return *this; }
+        bool operator!=(const const_iterator &it) const { return m_i != it.m_i; }
+    private:
+        const GDCPoints *m_pPoints;
+        size_t m_i;
+    };
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const   { return const_iterator(this, m_nCount); }
+
+// Attributes
+private:
+    const char *m_pX {nullptr};
+    const char *m_pY {nullptr};
+    size_t m_nCount  {0};
+    size_t m_nStride {sizeof(GDCPoint)};
+};
 
 template <class TPoint, typename FnConversion>
 inline std::vector<GDCPoint> Poly2Gdc(const std::vector<TPoint> &src_poly, FnConversion fnConversion)
@@ -228,23 +322,283 @@ inline std::vector<GDCPoint> Poly2Gdc(const std::vector<TPoint> &src_poly, FnCon
     return gdc_poly;
 }
 
-/*
-class GDC_UTIL_API GDCPath
+// Model to device conversion: x' = x * m_dScaleX + m_dOffsetX, y' = y * m_dScaleY + m_dOffsetY,
+// rounded to the nearest integer (halfway -> even) and clamped to the int32_t range
+class GDC_UTIL_API GDCAffine final
 {
+// Construction/Destruction
 public:
-    void MoveTo(int32_t x, ..
-    void LineTo...
+    GDCAffine() { }
+    GDCAffine(double dScaleX, double dScaleY, double dOffsetX, double dOffsetY)
+        : m_dScaleX(dScaleX), m_dScaleY(dScaleY), m_dOffsetX(dOffsetX), m_dOffsetY(dOffsetY) { }
+    ~GDCAffine() { }
 
 // Attributes
+public:
+    double m_dScaleX  {1.};
+    double m_dScaleY  {1.};
+    double m_dOffsetX {0.};
+    double m_dOffsetY {0.};
+};
+
+// Batch conversion (SSE2/AVX, scalar on the other platforms), pDst must have nCount points.
+// pXY: interleaved x, y pairs
+GDC_UTIL_API void Affine2Gdc(const double *pXY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst);
+// pX, pY: separate arrays (SoA)
+GDC_UTIL_API void Affine2Gdc(const double *pX, const double *pY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst);
+
+// TPoint: struct of the two doubles x, y (in this order), dst_poly capacity is reused
+template <class TPoint>
+inline void Poly2Gdc(const std::vector<TPoint> &src_poly, const GDCAffine &affine, std::vector<GDCPoint> &dst_poly)
+{
+    static_assert(std::is_same<decltype(TPoint::x), double>::value && std::is_same<decltype(TPoint::y), double>::value &&
+                  sizeof(TPoint) == 2 * sizeof(double), "x, y doubles expected");
+    dst_poly.resize(src_poly.size());
+    if ( !src_poly.empty() ) {
+        ::Affine2Gdc(&src_poly[0].x, src_poly.size(), affine, dst_poly.data());
+    }
+}
+
+template <class TPoint>
+inline std::vector<GDCPoint> Poly2Gdc(const std::vector<TPoint> &src_poly, const GDCAffine &affine)
+{
+    std::vector<GDCPoint> gdc_poly;
+    ::Poly2Gdc(src_poly, affine, gdc_poly);
+    return gdc_poly;
+}
+
+class GDC_UTIL_API GDCCleanStats final
+{
+// Attributes
+public:
+    uint64_t m_nDuplicates {0}; // consecutive equal points
+    uint64_t m_nCollinear  {0}; // points inside of the straight segment
+    uint64_t m_nZeroArea   {0}; // rings without area (nothing to fill)
+};
+
+// pt2 lies inside of the segment pt1-pt3 (exact for the coordinates up to 2^30)
+inline bool IsGdcStraight(const GDCPoint &pt1, const GDCPoint &pt2, const GDCPoint &pt3)
+{
+    const int64_t dx1 = (int64_t)pt2.x - pt1.x;
+    const int64_t dy1 = (int64_t)pt2.y - pt1.y;
+    const int64_t dx2 = (int64_t)pt3.x - pt2.x;
+    const int64_t dy2 = (int64_t)pt3.y - pt2.y;
+    return dx1 * dy2 == dy1 * dx2 && dx1 * dx2 + dy1 * dy2 > 0;
+}
+
+// Lossless cleanup: consecutive duplicates and exactly collinear points are removed,
+// the closing point of the ring (last == first) is kept.
+// returns false if the ring (bRing) has no area
+inline bool CleanGdcPoly(std::vector<GDCPoint> &poly, bool bRing, GDCCleanStats *pStats = nullptr)
+{
+    uint64_t nDuplicates = 0;
+    uint64_t nCollinear  = 0;
+    const size_t nSize = poly.size();
+    const bool bClosed = bRing && nSize > 1 && poly.front().x == poly.back().x && poly.front().y == poly.back().y;
+    const size_t nCount = bClosed ? nSize - 1 : nSize;
+
+    size_t n = 0;
+    for (size_t i = 0; i < nCount; ++i) {
+        const GDCPoint pt(poly[i]);
+        if ( n > 0 && poly[n - 1].x == pt.x && poly[n - 1].y == pt.y ) {
+            ++nDuplicates;
+            continue;
+        }
+        while ( n > 1 && ::IsGdcStraight(poly[n - 2], poly[n - 1], pt) ) {
+            --n;
+            ++nCollinear;
+        }
+        poly[n].x = pt.x;
+        poly[n].y = pt.y;
+        ++n;
+    }
+
+    size_t nFirst = 0;
+    bool bArea = !bRing;
+    if ( bRing ) {
+        // ring: the last point is followed by the first one
+        while ( n > 1 && poly[n - 1].x == poly[0].x && poly[n - 1].y == poly[0].y ) {
+            --n;
+            ++nDuplicates;
+        }
+        while ( n - nFirst >= 3 ) {
+            if ( ::IsGdcStraight(poly[n - 2], poly[n - 1], poly[nFirst]) ) {
+                --n;
+            }
+            else if ( ::IsGdcStraight(poly[n - 1], poly[nFirst], poly[nFirst + 1]) ) {
+                ++nFirst;
+            }
+            else {
+                break;
+            }
+            ++nCollinear;
+        }
+        // all points on the one line
+        const GDCPoint &pt0 = poly[nFirst];
+        for (size_t i = nFirst + 2; i < n && !bArea; ++i) {
+            const int64_t dx1 = (int64_t)poly[nFirst + 1].x - pt0.x;
+            const int64_t dy1 = (int64_t)poly[nFirst + 1].y - pt0.y;
+            bArea = dx1 * ((int64_t)poly[i].y - pt0.y) != dy1 * ((int64_t)poly[i].x - pt0.x);
+        }
+    }
+
+    if ( nFirst > 0 ) {
+        for (size_t i = nFirst; i < n; ++i) {
+            poly[i - nFirst].x = poly[i].x;
+            poly[i - nFirst].y = poly[i].y;
+        }
+        n -= nFirst;
+    }
+    poly.resize(n, GDCPoint());
+    if ( bClosed && n > 0 ) {
+        poly.emplace_back(poly[0].x, poly[0].y);
+    }
+
+    if ( pStats ) {
+        pStats->m_nDuplicates += nDuplicates;
+        pStats->m_nCollinear  += nCollinear;
+        pStats->m_nZeroArea   += bArea ? 0 : 1;
+    }
+    return bArea;
+}
+
+inline bool CleanGdcPoly(const GDCPoints &src_poly, std::vector<GDCPoint> &dst_poly, bool bRing, GDCCleanStats *pStats = nullptr)
+{
+    dst_poly.clear();
+    dst_poly.reserve(src_poly.size());
+    for (size_t i = 0; i < src_poly.size(); ++i) {
+        dst_poly.emplace_back(src_poly.X(i), src_poly.Y(i));
+    }
+    return ::CleanGdcPoly(dst_poly, bRing, pStats);
+}
+
+enum GDCFillRule
+{
+    GDC_FILL_RULE_NONZERO = 0,
+    GDC_FILL_RULE_EVENODD = 1
+};
+
+enum GDCPathVerb
+{
+    GDC_PATH_MOVE  = 0,
+    GDC_PATH_LINE  = 1,
+    GDC_PATH_ARC   = 2,
+    GDC_PATH_CLOSE = 3,
+    GDC_PATH_QUAD  = 4, // control point, end point
+    GDC_PATH_CUBIC = 5  // two control points, end point
+};
+
+// Arc as GDC::DrawArc (AngleArc): degrees, counter clockwise, y axis goes down
+class GDC_UTIL_API GDCPathArc final
+{
+// Operations
+public:
+    GDCPoint GetStart() const { return GetPoint(m_fStartAngle); }
+    GDCPoint GetEnd() const   { return GetPoint(m_fStartAngle + m_fSweepAngle); }
+    GDCPoint GetPoint(float fAngle) const;
+
+// Attributes
+public:
+    GDCPoint m_center;
+    int32_t m_nRadius {0};
+    float m_fStartAngle {0.f};
+    float m_fSweepAngle {0.f};
+};
+
+class CAbsPath;
+
+// Retained path: subpaths of the lines and arcs. Backends keep their prepared form of the path
+// (encoded data, platform points) inside of the object -> geometry which is drawn every frame is prepared once.
+class GDC_UTIL_API GDCPath final
+{
+// Construction/Destruction
+public:
+    GDCPath() { }
+    GDCPath(const GDCPath &path);
+    ~GDCPath();
+
+// Operators
+public:
+    GDCPath &operator=(const GDCPath &path);
+
+// Operations
+public:
+    void MoveTo(int32_t x, int32_t y);
+    void LineTo(int32_t x, int32_t y);
+    template <class TPoint>
+    void MoveTo(const TPoint &pt) { MoveTo(pt.x, pt.y); }
+    template <class TPoint>
+    void LineTo(const TPoint &pt) { LineTo(pt.x, pt.y); }
+    // line from the current point to the arc start (new subpath if there is no current point)
+    void Arc(int32_t x, int32_t y, int32_t nRadius, float fStartAngle, float fSweepAngle);
+    // bezier curves from the current point (x1, y1, x2, y2 - control points)
+    void QuadTo(int32_t x1, int32_t y1, int32_t x, int32_t y);
+    void CubicTo(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t x, int32_t y);
+    void Close();
+    void Clear();
+
+    void SetFillRule(GDCFillRule rule) { m_fill_rule = rule; }
+    GDCFillRule GetFillRule() const    { return m_fill_rule; }
+
+    bool IsEmpty() const { return m_verbs.empty(); }
+    bool HasCurves() const;
+    // points (control points included) and circles of the arcs, false if empty
+    bool GetBounds(RECT &rect) const;
+
+    const std::vector<uint8_t> &GetVerbs() const     { return m_verbs;  } // GDCPathVerb
+    const std::vector<GDCPoint> &GetPoints() const   { return m_points; } // GDC_PATH_MOVE, GDC_PATH_LINE, GDC_PATH_QUAD, GDC_PATH_CUBIC
+    const std::vector<GDCPathArc> &GetArcs() const   { return m_arcs;   } // GDC_PATH_ARC
+
 private:
-    friend class GDC;
-    std::vector<GDCPoint> ..
+    void ResetCache();
+
+// Attributes
+private:
+    friend class SvgGDC;
+    friend class CMswGDC;
+    mutable CAbsPath *m_pSvgPath {nullptr};
+    mutable CAbsPath *m_pMswPath {nullptr};
+
+    std::vector<uint8_t> m_verbs;
+    std::vector<GDCPoint> m_points;
+    std::vector<GDCPathArc> m_arcs;
+    GDCFillRule m_fill_rule {GDC_FILL_RULE_NONZERO};
 };
-*/
+
+// Curve flattening for the raster backends: points after pt0 (end point included) are appended,
+// segment count is from the second differences -> chords deviate from the curve up to the dTolerance
+// (plus the rounding to the integer points).
+GDC_UTIL_API void FlattenGdcQuad(const GDCPoint &pt0, const GDCPoint &pt1, const GDCPoint &pt2, 
+                                 double dTolerance, std::vector<GDCPoint> &points);
+GDC_UTIL_API void FlattenGdcCubic(const GDCPoint &pt0, const GDCPoint &pt1, const GDCPoint &pt2, const GDCPoint &pt3, 
+                                  double dTolerance, std::vector<GDCPoint> &points);
+
 
 class GDCBitmap;
 class GDCSvg;
+class GDCDisplayList;
+class GDCDisplayFile;
 class CAbsGDC;
+class CSimplifyGDC;
+
+// Level of detail: sizes are in the device pixels (GDC units * device scale), 0 -> disabled
+class GDC_UTIL_API GDCLodPolicy final
+{
+// Attributes
+public:
+    float m_fDropSize      {0.f}; // primitives with the smaller bounding box are not drawn
+    float m_fCollapseSize  {0.f}; // smaller polygons are drawn as the bounding rectangle, polylines as the single line
+    float m_fMinTextHeight {0.f}; // smaller text is not drawn
+};
+
+class GDC_UTIL_API GDCLodStats final
+{
+// Attributes
+public:
+    uint64_t m_nDropped     {0};
+    uint64_t m_nCollapsed   {0};
+    uint64_t m_nTextSkipped {0};
+};
 
 class GDC_UTIL_API GDC
 {
@@ -254,6 +608,8 @@ public:
     GDC(GDCBitmap &bitmap, COLORREF background = RGB(255, 255, 255));
     GDC(GDCSvg &svg);
     GDC(HWND hwnd);
+    // every call is recorded into the list (appended)
+    GDC(GDCDisplayList &list);
     ~GDC();
 
 private:
@@ -275,15 +631,41 @@ public:
 
     // https://stackoverflow.com/questions/13545792/drawing-a-filled-rectangle-with-a-border-in-android
     // special function to keep current code compatibility
-    void DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint);
-    void DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint); // closed line => polygon
-    void DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint);
+    void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint);
+    void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint); // closed line => polygon
+    void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint);
     // special case -> avoid if statements in the general drawings
-    void DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint);
-    void DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo);
+    void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint);
+    void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo);
+    void DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) {
+        DrawPolygon(GDCPoints(points), fill_paint, stroke_paint);
+    }
+    void DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) {
+        DrawPoly(GDCPoints(points), stroke_paint);
+    }
+    void DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) {
+        DrawPolyLine(GDCPoints(points), stroke_paint);
+    }
+    void DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint) {
+        DrawPolygonTransparent(GDCPoints(points), fill_paint);
+    }
+    void DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) {
+        DrawPolygonGradient(GDCPoints(points), paintFrom, paintTo);
+    }
     void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom);
     void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude, const wchar_t * sTexturePath, double dAngle, float fZoom);
 
+    // sub-pixel coordinates, cleanup and simplification are not applied
+    void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint);
+    void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint);
+    void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint);
+    void DrawPolyLineF(const std::vector<GDCPointF> &points, const GDCPaint &stroke_paint) {
+        DrawPolyLineF(points.data(), points.size(), stroke_paint);
+    }
+    void DrawPolygonF(const std::vector<GDCPointF> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) {
+        DrawPolygonF(points.data(), points.size(), fill_paint, stroke_paint);
+    }
+
     void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint);
     template <class TRect>
     void DrawFilledRectangle(const TRect &rect, const GDCPaint &fill_paint) {
@@ -299,6 +681,18 @@ public:
         DrawRectangle(pt.x - nSize, pt.y - nSize, pt.x + nSize, pt.y + nSize, paint); 
     }
 
+    // Batches: one paint setup and one backend call for the whole array (LOD policy is not applied)
+    // segments: points[0]-points[1], points[2]-points[3], ...
+    void DrawLines(const GDCPoints &points, const GDCPaint &paint);
+    // rectangles: corners[0]-corners[1], corners[2]-corners[3], ... (RECT array: GDCPoints::Corners)
+    void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint);
+    void DrawRectsOnPoints(const GDCPoints &points, int32_t nSize, const GDCPaint &stroke_paint);
+    void DrawPoints(const GDCPoints &points, const GDCPaint &paint);
+
+    void DrawPath(const GDCPath &path, const GDCPaint &fill_paint, const GDCPaint &stroke_paint);
+    void DrawPath(const GDCPath &path, const GDCPaint &stroke_paint);
+    void FillPath(const GDCPath &path, const GDCPaint &fill_paint);
+
     void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint);
     template <class TRect>
     void DrawEllipse(const TRect &rect, const GDCPaint &paint) {
@@ -349,9 +743,52 @@ public:
     void BeginGroup(const char *sGroupAttributes);
     void EndGroup();
 
+    // recorded commands go straight to the backend: LOD, cleanup and simplification were applied while recording
+    void Replay(const GDCDisplayList &list);
+    void Replay(const GDCDisplayFile &file);
+    // one group (GDCDisplayList::GetGroups) with the current viewport and curve tolerance
+    void ReplayGroup(const GDCDisplayList &list, size_t iGroup);
+    void ReplayGroup(const GDCDisplayFile &file, size_t iGroup);
+    // drawing commands which bounds intersect the rect (GDC units, recorded viewport origin applied) in the draw order,
+    // the cost depends on the visible part only. Groups are not replayed. Recorded viewport origin changes are replayed
+    // as by the Replay, list without them is drawn with the current viewport (panning).
+    void ReplayRegion(const GDCDisplayList &list, const RECT &rect);
+    void ReplayRegion(const GDCDisplayFile &file, const RECT &rect);
+
+    // device pixels per GDC unit (e.g. zoom of the overview), used by the LOD policy. Not positive scale is ignored.
+    void SetDeviceScale(float fScale);
+    void SetLodPolicy(const GDCLodPolicy &policy);
+    const GDCLodStats &GetLodStats() const { return m_lod_stats; }
+    // polylines and polygons are simplified before they reach the backend,
+    // fTolerance is in the device pixels (SetDeviceScale). Ring which new edges would cross the other ones is drawn as is.
+    void SetSimplify(GDCSimplifyMode mode, float fTolerance);
+    // duplicate and collinear points are removed before the polylines and polygons reach the backend,
+    // polygons without area are not filled (CleanGdcPoly)
+    void SetCleanup(bool bCleanup) { m_bCleanup = bCleanup; }
+    const GDCCleanStats &GetCleanStats() const { return m_clean_stats; }
+
+private:
+    bool IsLodDropped(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+    // empty path or the small one (bounds are calculated only with the LOD policy)
+    bool IsPathDropped(const GDCPath &path);
+    bool IsTextSkipped(const GDCPaint &paint);
+
 // Attributes
 private:
     CAbsGDC *m_pDC;
+    CAbsGDC *m_pBackend {nullptr}; // m_pDC without the decorators, replay target
+    bool m_bLod {false};
+    float m_fDeviceScale {1.f};
+    GDCLodPolicy m_lod;
+    GDCLodStats m_lod_stats;
+    std::vector<GDCPoint> m_lod_rect; // collapsed polygon
+    CSimplifyGDC *m_pSimplify {nullptr}; // decorator of the backend, owned by the m_pDC chain
+    GDCSimplifyMode m_simplify_mode {GDC_SIMPLIFY_NONE};
+    float m_fSimplifyTolerance {0.f};
+    bool m_bCleanup {false};
+    GDCCleanStats m_clean_stats;
+    std::vector<GDCPoint> m_clean; // cleaned copy of the points
+    std::vector<GDCPoint> m_batch; // DrawRectsOnPoints corners
 };
 
 class CAbsBitmap;
@@ -374,6 +811,16 @@ private:
     CAbsBitmap *m_pBitmap;
 };
 
+class GDC_UTIL_API GDCSvgStats final
+{
+// Attributes
+public:
+    uint64_t m_nBytes   {0}; // bytes passed to the file
+    uint64_t m_nFlushes {0}; // blocks written into the file
+    uint64_t m_nCulled  {0}; // primitives outside of the visible rectangle (GDCSvg::SetCulling)
+    bool m_bError {false};   // file could not be created or written
+};
+
 class GDC_UTIL_API GDCSvg final
 {
 // Construction/Destruction
@@ -393,16 +840,168 @@ public:
     // if multiple svg images are going to be shown in the one html page
     // gradient id's must be unique
     void SetPrefix(const char *sPrefix);
+    // file output is collected into the blocks of the nBlockSize bytes (default 1MB)
+    void SetFileBlockSize(size_t nBlockSize);
+    // file is written by the background thread while drawing continues (double buffered blocks)
+    // GDC destructor waits until everything is written
+    void SetAsyncWrite(bool bAsync);
+    // gzip compressed output (.svgz), nLevel: 0 (stored) .. 9 (best), -1 -> plain text (default)
+    // with the async write compression runs in the writer thread
+    void SetCompression(int32_t nLevel);
+    // every distinct style is written once into the <style> block as the class (prefix + "s" + id),
+    // elements reference it by class="..." instead of the inline style="..."
+    void SetStyleClasses(bool bStyleClasses);
+    // content is kept in memory until the GDC is destroyed, then the <svg> root and the single <defs> section
+    // are written in front of it. bFitViewBox: viewBox is calculated from the drawn extents
+    void SetDeferredHeader(bool bDeferred, bool bFitViewBox = false);
+    // consecutive DrawLine calls with the same stroke are written as the one <path d="M..L..M..L..">
+    void SetMergeLines(bool bMergeLines);
+    // shapes which differ only by the translation (points, rectangles, ellipses, small polygons): the first one is written
+    // as is, repeated ones are defined once as the <symbol> and written as <use x= y=>
+    void SetInstancing(bool bInstancing);
+    // primitives outside of the visible rectangle (SetViewportOrg, width, height) are not written,
+    // groups without visible elements are dropped too. Ignored with the fitted viewBox.
+    void SetCulling(bool bCulling);
+    // file output counters, updated while drawing (with the async write valid after GDC is destroyed)
+    const GDCSvgStats &GetStats() const { return m_stats; }
 
 // Attributes
 private:
-    friend class GDC;
+    friend class SvgGDC;
     int32_t m_nWidth;
     int32_t m_nHeight;
     bool m_bAutoSize {false};
     std::wstring m_sFilePath;
     std::string *m_pBuffer {nullptr};
     std::string m_sPrefix;
+    size_t m_nFileBlockSize {1024 * 1024};
+    bool m_bAsyncWrite {false};
+    int32_t m_nCompression {-1};
+    bool m_bStyleClasses {false};
+    bool m_bDeferredHeader {false};
+    bool m_bFitViewBox {false};
+    bool m_bMergeLines {false};
+    bool m_bInstancing {false};
+    bool m_bCulling {false};
+    GDCSvgStats m_stats;
+};
+
+class CListResources;
+class CListFile;
+class CListSections;
+class CListIndex;
+
+// Group of the display list: [m_nBegin, m_nEnd) of the command stream, BeginGroup .. EndGroup commands included.
+// Layout is stored in the display list file as is.
+class GDC_UTIL_API GDCListGroup final
+{
+// Attributes
+public:
+    uint64_t m_nBegin {0};
+    uint64_t m_nEnd   {0}; // 0 -> group is not closed
+    int32_t m_xLast   {0}; // delta coding state at the m_nBegin
+    int32_t m_yLast   {0};
+    uint32_t m_nDepth {0}; // nested groups
+    uint32_t m_nReserved {0};
+};
+
+// Topmost recorded drawing at the point (GDCDisplayList::HitTest)
+class GDC_UTIL_API GDCListHit final
+{
+// Attributes
+public:
+    uint64_t m_nOffset {0};       // command in the stream
+    RECT m_bounds {0, 0, 0, 0};   // spatial index bounds of the command (stroke included)
+    size_t m_iGroup {SIZE_MAX};   // innermost enclosing group, SIZE_MAX: none
+    std::string m_sGroupAttributes;
+};
+
+// Recorded drawing: compact binary command stream (delta/varint coordinates, paints and paths are stored once).
+// Model traversal runs once, the list is replayed into any GDC (screen, svg, bitmap) as many times as required.
+class GDC_UTIL_API GDCDisplayList final
+{
+// Construction/Destruction
+public:
+    GDCDisplayList() { }
+    ~GDCDisplayList();
+
+private:
+    GDCDisplayList(const GDCDisplayList &list);
+
+// Operations
+public:
+    void Clear();
+    bool IsEmpty() const                    { return m_data.empty(); }
+    size_t GetCommandCount() const          { return m_nCommands; }
+    const std::vector<uint8_t> &GetData() const { return m_data; } // command stream
+    const std::vector<GDCListGroup> &GetGroups() const { return m_groups; }
+
+    // versioned file for the GDCDisplayFile, false on the write error. Bitmaps are recorded as the HBITMAP handles
+    // (valid only in this process) -> list with the DrawBitmap is not saved (false).
+    bool Save(const wchar_t *sFilePath) const;
+
+    // topmost drawing command which geometry (fill, stroke, text box) is within the nTolerance from the point (GDC units,
+    // recorded viewport origin applied), candidates come from the spatial index. Bitmaps are not hit. False: nothing is hit.
+    bool HitTest(int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit) const;
+
+    // dirty rectangles (GDC units) against the previous recording of the scene: bounds of the changed, added and removed
+    // drawing commands, touching ones are joined and at most nMaxRects are returned (GDC::ReplayRegion each of them).
+    // Many changes (more than nMaxRects * 32 or 1024) are joined by the grid cells first, so the rectangles cover some more area.
+    // Groups are matched by the attributes and the content, moves in the draw order of the equal drawing are not detected.
+    // Changed recorded viewport origin gives the full extent rectangle (whole view is redrawn).
+    void Diff(const GDCDisplayList &previous, size_t nMaxRects, std::vector<RECT> &dirty) const;
+
+private:
+    void GetSections(CListSections &sections) const;
+    CListResources &GetResources() const;
+
+// Attributes
+private:
+    friend class CRecordGDC;
+    friend class GDC;
+    std::vector<uint8_t> m_data;
+    std::vector<uint8_t> m_defs; // paint and path definitions
+    std::vector<GDCListGroup> m_groups;
+    size_t m_nCommands {0};
+    uint32_t m_nPaints {0}; // ids given by the recorders
+    uint32_t m_nPaths  {0};
+    size_t m_nBitmaps  {0};
+    GDCPoint m_last;        // delta coding continues with the next recorder
+    mutable CListResources *m_pResources {nullptr}; // decoded paints and paths -> backend caches are reused by the replays
+    CListIndex *m_pIndex {nullptr};                  // R-tree over the drawing commands (built by the recorder)
+};
+
+// Display list file (GDCDisplayList::Save) mapped into the memory: opening time does not depend on the scene size,
+// commands are replayed straight from the mapping (nothing is copied into the heap).
+class GDC_UTIL_API GDCDisplayFile final
+{
+// Construction/Destruction
+public:
+    GDCDisplayFile() { }
+    ~GDCDisplayFile();
+
+private:
+    GDCDisplayFile(const GDCDisplayFile &file);
+
+// Operations
+public:
+    // false: file is missing, not a display list or the version is newer
+    bool Open(const wchar_t *sFilePath);
+    void Close();
+    bool IsOpen() const { return m_pFile != nullptr; }
+
+    size_t GetCommandCount() const;
+    size_t GetGroupCount() const;
+    const GDCListGroup *GetGroup(size_t iGroup) const;
+    // BeginGroup attributes
+    std::string GetGroupAttributes(size_t iGroup) const;
+    // GDCDisplayList::HitTest
+    bool HitTest(int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit) const;
+
+// Attributes
+private:
+    friend class GDC;
+    CListFile *m_pFile {nullptr};
 };
 
 #endif
\ No newline at end of file
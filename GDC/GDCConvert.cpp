@@ -0,0 +1,174 @@
+#include "stdafx.h"
+#include "GDC.h"
+
+#include "math.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+    #define GDC_CONVERT_SSE2
+    #include "immintrin.h"
+    #ifdef _MSC_VER
+        #include "intrin.h"
+        #define GDC_TARGET_AVX
+    #else
+        #include "cpuid.h"
+        #define GDC_TARGET_AVX __attribute__((target("avx")))
+    #endif
+#endif
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+namespace internal
+{
+    static const double g_dMin = (double)INT32_MIN;
+    static const double g_dMax = (double)INT32_MAX;
+
+    // current rounding mode (default: to nearest even) as the cvtpd_epi32 does
+    static inline int32_t Round(double dValue)
+    {
+        dValue = (dValue < g_dMin) ? g_dMin : (dValue > g_dMax) ? g_dMax : dValue;
+        return (int32_t)::nearbyint(dValue);
+    }
+
+    static void Affine2GdcScalar(const double *pX, const double *pY, size_t nStride, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+    {
+        for (size_t i = 0; i < nCount; ++i) {
+            pDst[i].x = Round(pX[i * nStride] * affine.m_dScaleX + affine.m_dOffsetX);
+            pDst[i].y = Round(pY[i * nStride] * affine.m_dScaleY + affine.m_dOffsetY);
+        }
+    }
+
+#ifdef GDC_CONVERT_SSE2
+    // OS must save the ymm registers too
+    static bool IsAvxSupported()
+    {
+    #ifdef _MSC_VER
+        int info[4];
+        ::__cpuid(info, 1);
+        const bool bAvx = (info[2] & (1 << 28)) && (info[2] & (1 << 27)); // avx, osxsave
+        return bAvx && (::_xgetbv(0) & 6) == 6;
+    #else
+        unsigned int eax, ebx, ecx, edx;
+        if ( !::__get_cpuid(1, &eax, &ebx, &ecx, &edx) || !(ecx & bit_AVX) || !(ecx & bit_OSXSAVE) ) {
+            return false;
+        }
+        unsigned int xcr0, xcr0_hi;
+        __asm__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        return (xcr0 & 6) == 6;
+    #endif
+    }
+
+    static const bool g_bAvx = IsAvxSupported();
+
+    // x y x y ... -> int32 pairs have the GDCPoint layout, no shuffles are required
+    static void Affine2GdcSSE2(const double *pXY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+    {
+        const __m128d scale  = _mm_setr_pd(affine.m_dScaleX,  affine.m_dScaleY);
+        const __m128d offset = _mm_setr_pd(affine.m_dOffsetX, affine.m_dOffsetY);
+        const __m128d vmin   = _mm_set1_pd(g_dMin);
+        const __m128d vmax   = _mm_set1_pd(g_dMax);
+        size_t i = 0;
+        for (; i + 2 <= nCount; i += 2) {
+            __m128d pt1 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(pXY + 2 * i),     scale), offset);
+            __m128d pt2 = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(pXY + 2 * i + 2), scale), offset);
+            pt1 = _mm_min_pd(_mm_max_pd(pt1, vmin), vmax);
+            pt2 = _mm_min_pd(_mm_max_pd(pt2, vmin), vmax);
+            const __m128i res = _mm_unpacklo_epi64(_mm_cvtpd_epi32(pt1), _mm_cvtpd_epi32(pt2));
+            _mm_storeu_si128((__m128i *)(pDst + i), res);
+        }
+        Affine2GdcScalar(pXY + 2 * i, pXY + 2 * i + 1, 2, nCount - i, affine, pDst + i);
+    }
+
+    static void Affine2GdcSSE2(const double *pX, const double *pY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+    {
+        const __m128d scale_x  = _mm_set1_pd(affine.m_dScaleX);
+        const __m128d scale_y  = _mm_set1_pd(affine.m_dScaleY);
+        const __m128d offset_x = _mm_set1_pd(affine.m_dOffsetX);
+        const __m128d offset_y = _mm_set1_pd(affine.m_dOffsetY);
+        const __m128d vmin     = _mm_set1_pd(g_dMin);
+        const __m128d vmax     = _mm_set1_pd(g_dMax);
+        size_t i = 0;
+        for (; i + 2 <= nCount; i += 2) {
+            __m128d x = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(pX + i), scale_x), offset_x);
+            __m128d y = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(pY + i), scale_y), offset_y);
+            x = _mm_min_pd(_mm_max_pd(x, vmin), vmax);
+            y = _mm_min_pd(_mm_max_pd(y, vmin), vmax);
+            const __m128i res = _mm_unpacklo_epi32(_mm_cvtpd_epi32(x), _mm_cvtpd_epi32(y)); // x0 y0 x1 y1
+            _mm_storeu_si128((__m128i *)(pDst + i), res);
+        }
+        Affine2GdcScalar(pX + i, pY + i, 1, nCount - i, affine, pDst + i);
+    }
+
+    GDC_TARGET_AVX static void Affine2GdcAVX(const double *pXY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+    {
+        const __m256d scale  = _mm256_setr_pd(affine.m_dScaleX,  affine.m_dScaleY,  affine.m_dScaleX,  affine.m_dScaleY);
+        const __m256d offset = _mm256_setr_pd(affine.m_dOffsetX, affine.m_dOffsetY, affine.m_dOffsetX, affine.m_dOffsetY);
+        const __m256d vmin   = _mm256_set1_pd(g_dMin);
+        const __m256d vmax   = _mm256_set1_pd(g_dMax);
+        size_t i = 0;
+        for (; i + 4 <= nCount; i += 4) {
+            __m256d pt1 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(pXY + 2 * i),     scale), offset);
+            __m256d pt2 = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(pXY + 2 * i + 4), scale), offset);
+            pt1 = _mm256_min_pd(_mm256_max_pd(pt1, vmin), vmax);
+            pt2 = _mm256_min_pd(_mm256_max_pd(pt2, vmin), vmax);
+            _mm_storeu_si128((__m128i *)(pDst + i),     _mm256_cvtpd_epi32(pt1));
+            _mm_storeu_si128((__m128i *)(pDst + i + 2), _mm256_cvtpd_epi32(pt2));
+        }
+        _mm256_zeroupper();
+        Affine2GdcSSE2(pXY + 2 * i, nCount - i, affine, pDst + i);
+    }
+
+    GDC_TARGET_AVX static void Affine2GdcAVX(const double *pX, const double *pY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+    {
+        const __m256d scale_x  = _mm256_set1_pd(affine.m_dScaleX);
+        const __m256d scale_y  = _mm256_set1_pd(affine.m_dScaleY);
+        const __m256d offset_x = _mm256_set1_pd(affine.m_dOffsetX);
+        const __m256d offset_y = _mm256_set1_pd(affine.m_dOffsetY);
+        const __m256d vmin     = _mm256_set1_pd(g_dMin);
+        const __m256d vmax     = _mm256_set1_pd(g_dMax);
+        size_t i = 0;
+        for (; i + 4 <= nCount; i += 4) {
+            __m256d x = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(pX + i), scale_x), offset_x);
+            __m256d y = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(pY + i), scale_y), offset_y);
+            x = _mm256_min_pd(_mm256_max_pd(x, vmin), vmax);
+            y = _mm256_min_pd(_mm256_max_pd(y, vmin), vmax);
+            const __m128i xi = _mm256_cvtpd_epi32(x);
+            const __m128i yi = _mm256_cvtpd_epi32(y);
+            _mm_storeu_si128((__m128i *)(pDst + i),     _mm_unpacklo_epi32(xi, yi));
+            _mm_storeu_si128((__m128i *)(pDst + i + 2), _mm_unpackhi_epi32(xi, yi));
+        }
+        _mm256_zeroupper();
+        Affine2GdcSSE2(pX + i, pY + i, nCount - i, affine, pDst + i);
+    }
+#endif
+};
+
+void Affine2Gdc(const double *pXY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+{
+    static_assert(sizeof(GDCPoint) == 2 * sizeof(int32_t), "GDCPoint layout");
+#ifdef GDC_CONVERT_SSE2
+    if ( internal::g_bAvx ) {
+        internal::Affine2GdcAVX(pXY, nCount, affine, pDst);
+    }
+    else {
+        internal::Affine2GdcSSE2(pXY, nCount, affine, pDst);
+    }
+#else
+    internal::Affine2GdcScalar(pXY, pXY + 1, 2, nCount, affine, pDst);
+#endif
+}
+
+void Affine2Gdc(const double *pX, const double *pY, size_t nCount, const GDCAffine &affine, GDCPoint *pDst)
+{
+#ifdef GDC_CONVERT_SSE2
+    if ( internal::g_bAvx ) {
+        internal::Affine2GdcAVX(pX, pY, nCount, affine, pDst);
+    }
+    else {
+        internal::Affine2GdcSSE2(pX, pY, nCount, affine, pDst);
+    }
+#else
+    internal::Affine2GdcScalar(pX, pY, 1, nCount, affine, pDst);
+#endif
+}
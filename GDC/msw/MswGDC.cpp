@@ -6,6 +6,7 @@
 
 #include "MswBitmap.h"
 #include "MswPaint.h"
+#include "MswPath.h"
 
 #include "gdi_plus_util.h"
 #include "TextUtils/GdiPlusTextDrawUtils.h"
@@ -366,56 +367,52 @@ void CMswGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDC
     m_pDC->LineTo(x2, y2);
 }
 
-void CMswGDC::DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+const POINT *CMswGDC::GetPOINTs(const GDCPoints &points)
+{
+    static_assert(sizeof(POINT) == 2 * sizeof(int32_t), "POINT layout");
+    if ( points.IsPacked() ) {
+        return (const POINT *)points.PackedData();
+    }
+    const size_t nCnt = points.size();
+    m_points.resize(nCnt);
+    for (size_t i1 = 0; i1 < nCnt; ++i1) {
+        m_points[i1].x = points.X(i1);
+        m_points[i1].y = points.Y(i1);
+    }
+    return m_points.data();
+}
+
+void CMswGDC::DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
 {
     ODCInit::SelectStrokePaint(m_pDC, stroke_paint);
     ODCInit::SelectFillPaint(m_pDC, fill_paint);
     ODCInit::CBinaryRaster rop2(m_pDC, fill_paint);
 
-    int32_t nCnt = (int32_t)points.size();
-    POINT *pPoints = new POINT[points.size()];
-    int32_t i1 = 0;
-
-    for (const auto &pt : points) {
-        POINT &point = pPoints[i1];
-        point.x = pt.x;
-        point.y = pt.y;
-        ++i1;
-    }
-    m_pDC->Polygon(pPoints, nCnt);
-    delete [] pPoints;
+    m_pDC->Polygon((LPPOINT)GetPOINTs(points), (int32_t)points.size());
 }
 
-void CMswGDC::DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint)
+void CMswGDC::DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)
 {
     const size_t cnt = points.size();
 
     ODCInit::SelectStrokePaint(m_pDC, stroke_paint);
     ODCInit::CBinaryRaster rop2(m_pDC, stroke_paint);
 
-    const GDCPoint &pt = points.front();
+    const GDCPoint pt = points.front();
     m_pDC->MoveTo(pt);
-    for (auto i1 = 0; i1 < cnt; ++i1) {
-        m_pDC->LineTo(points[i1]);	
+    for (size_t i1 = 0; i1 < cnt; ++i1) {
+        m_pDC->LineTo(points.X(i1), points.Y(i1));
     }
-    m_pDC->LineTo(pt); // do close 
+    m_pDC->LineTo(pt.x, pt.y); // do close 
 }
 
-void CMswGDC::DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint)
+void CMswGDC::DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)
 {
     ASSERT(fill_paint.GetAlfa() != -1);
     unsigned char alfa = (unsigned char)fill_paint.GetAlfa();
     COLORREF color = fill_paint.GetColor();
-    std::vector<POINT> points2;
-    points2.reserve(points.size());
-    POINT point;
-    for (const GDCPoint &pt : points) {
-        point.x = pt.x;
-        point.y = pt.y;
-        points2.push_back(point);
-    }
 
-    CGdiPlusUtil::DrawPolygonTransparent(m_pDC->GetSafeHdc(), points2, alfa, 
+    CGdiPlusUtil::DrawPolygonTransparent(m_pDC->GetSafeHdc(), GetPOINTs(points), points.size(), alfa, 
                                          (unsigned char)GetRValue(color), (unsigned char)GetGValue(color), (unsigned char)GetBValue(color)); 
 
     // does not work as HWND required!!! TODO: wxwidgets must be asked -> HDC should be allowed
@@ -438,21 +435,12 @@ void CMswGDC::DrawPolygonTransparent(const std::vector<GDCPoint> &points, const
     */
 }
 
-void CMswGDC::DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
+void CMswGDC::DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
 {
     COLORREF colorFrom = paintFrom.GetColor();
     COLORREF colorTo   = paintTo.GetColor();
 
-    std::vector<POINT> points2;
-    points2.reserve(points.size());
-    POINT point;
-    for (const GDCPoint &pt : points) {
-        point.x = pt.x;
-        point.y = pt.y;
-        points2.push_back(point);
-    }
-
-    CGdiPlusUtil::DrawPolygon(m_pDC->GetSafeHdc(), points2, 
+    CGdiPlusUtil::DrawPolygon(m_pDC->GetSafeHdc(), GetPOINTs(points), points.size(), 
                              (unsigned char)GetRValue(colorFrom), (unsigned char)GetGValue(colorFrom), (unsigned char)GetBValue(colorFrom), 
                              (unsigned char)GetRValue(colorTo),   (unsigned char)GetGValue(colorTo),   (unsigned char)GetBValue(colorTo));
 }
@@ -510,16 +498,15 @@ void CMswGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std:
     delete[] gdi_points_exclude;
 }
 
-void CMswGDC::DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint)
+void CMswGDC::DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint)
 {
     ODCInit::SelectStrokePaint(m_pDC, stroke_paint);
     ODCInit::CBinaryRaster rop2(m_pDC, stroke_paint);
 
-    const GDCPoint &pt = points.front();
-    m_pDC->MoveTo(pt);
+    m_pDC->MoveTo(points.front());
     const size_t cnt = points.size();
-    for (auto i1 = 0; i1 < cnt; ++i1) {
-        m_pDC->LineTo(points[i1]);	
+    for (size_t i1 = 0; i1 < cnt; ++i1) {
+        m_pDC->LineTo(points.X(i1), points.Y(i1));
     }
 }
 
@@ -551,6 +538,271 @@ void CMswGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, cons
     m_pDC->Rectangle(x1, y1, x2, y2);
 }
 
+void CMswGDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    const size_t nCount = points.size() / 2;
+    if ( GDC_PS_SOLID != paint.GetStrokeType() && paint.GetStrokeWidth() > 1.0 ) {
+        for (size_t i1 = 0; i1 < nCount; ++i1) { // GDI+ (see DrawLine)
+            DrawLine(points.X(2 * i1), points.Y(2 * i1), points.X(2 * i1 + 1), points.Y(2 * i1 + 1), paint);
+        }
+        return;
+    }
+
+    ODCInit::SelectStrokePaint(m_pDC, paint);
+    ODCInit::CBinaryRaster rop2(m_pDC, paint);
+
+    const POINT *pPoints = GetPOINTs(points);
+    m_counts.assign(nCount, 2);
+    ::PolyPolyline(m_pDC->GetSafeHdc(), pPoints, m_counts.data(), (DWORD)nCount);
+}
+
+void CMswGDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    ODCInit::SelectStrokePaint(m_pDC, stroke_paint);
+    //Force to draw only line, no fill.
+    OBrush brush(NULL_BRUSH);
+    m_pDC->SelectObject(&brush);
+
+    ODCInit::CBinaryRaster rop2(m_pDC, stroke_paint);
+
+    const size_t nCount = corners.size() / 2;
+    for (size_t i1 = 0; i1 < nCount; ++i1) {
+        m_pDC->Rectangle(corners.X(2 * i1), corners.Y(2 * i1), corners.X(2 * i1 + 1), corners.Y(2 * i1 + 1));
+    }
+}
+
+void CMswGDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    // same as DrawPoint
+    ODCInit::SelectStrokePaint(m_pDC, paint);
+    ODCInit::CBinaryRaster rop2(m_pDC, paint);
+    for (const GDCPoint pt : points) {
+        m_pDC->MoveTo(pt.x, pt.y);
+        m_pDC->LineTo(pt.x, pt.y);
+    }
+}
+
+namespace internal
+{
+    // GDI+ takes the float coordinates as is: sub-pixel positions, anti-aliased edges
+    static inline void DrawPolyLineF(HDC hDC, const GDCPointF *pPoints, size_t nCount, bool bClose, const GDCPaint &paint)
+    {
+        static_assert(sizeof(GDCPointF) == 2 * sizeof(float), "GDCPointF layout");
+        const COLORREF color = paint.GetColor();
+        const unsigned char alfa = paint.GetAlfa() == -1 ? 255 : (unsigned char)paint.GetAlfa();
+        CGdiPlusUtil::DrawPolyLineF(hDC, (const float *)pPoints, nCount, bClose, paint.GetStrokeType(), paint.GetStrokeWidth(), alfa, 
+                                    (unsigned char)GetRValue(color), (unsigned char)GetGValue(color), (unsigned char)GetBValue(color));
+    }
+};
+
+void CMswGDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    const GDCPointF points[2] = { GDCPointF(x1, y1), GDCPointF(x2, y2) };
+    internal::DrawPolyLineF(m_pDC->GetSafeHdc(), points, 2, false, paint);
+}
+
+void CMswGDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    internal::DrawPolyLineF(m_pDC->GetSafeHdc(), pPoints, nCount, false, stroke_paint);
+}
+
+// fill: solid color of the fill_paint (hatch patterns are not supported by the sub-pixel drawing)
+void CMswGDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    const HDC hDC = m_pDC->GetSafeHdc();
+    const COLORREF color = fill_paint.GetColor();
+    const unsigned char alfa = fill_paint.GetAlfa() == -1 ? 255 : (unsigned char)fill_paint.GetAlfa();
+    CGdiPlusUtil::FillPolygonF(hDC, (const float *)pPoints, nCount, alfa,
+                               (unsigned char)GetRValue(color), (unsigned char)GetGValue(color), (unsigned char)GetBValue(color));
+    internal::DrawPolyLineF(hDC, pPoints, nCount, true, stroke_paint);
+}
+
+namespace internal
+{
+    static inline void AddPathPoint(CMswPath *pMswPath, double x, double y, BYTE type)
+    {
+        POINT pt;
+        pt.x = (LONG)::lround(x);
+        pt.y = (LONG)::lround(y);
+        pMswPath->m_points.push_back(pt);
+        pMswPath->m_types.push_back(type);
+    }
+
+    // arc by the bezier segments up to the 90 degrees, the start point is already added
+    static void AddPathArc(CMswPath *pMswPath, const GDCPathArc &arc)
+    {
+        const double dPI     = 3.1415926535897932384626433832795;
+        const double cx      = arc.m_center.x;
+        const double cy      = arc.m_center.y;
+        const double r       = arc.m_nRadius;
+        const double dSweep  = (std::max)(-360.0, (std::min)(360.0, (double)arc.m_fSweepAngle)) * dPI / 180.0;
+        const int32_t nSegs  = (std::max)(1, (int32_t)::ceil(::fabs(dSweep) / (dPI * 0.5) - 1e-9));
+        const double dSeg    = dSweep / nSegs;
+        const double k       = 4.0 / 3.0 * ::tan(dSeg / 4.0);
+        double a0 = arc.m_fStartAngle * dPI / 180.0;
+        for (int32_t i1 = 0; i1 < nSegs; ++i1) {
+            const double a1 = a0 + dSeg;
+            // y axis goes down: P(a) = (cx + r*cos(a), cy - r*sin(a)), P'(a) = (-r*sin(a), -r*cos(a))
+            const double x0 = cx + r * ::cos(a0);
+            const double y0 = cy - r * ::sin(a0);
+            const double x3 = cx + r * ::cos(a1);
+            const double y3 = cy - r * ::sin(a1);
+            AddPathPoint(pMswPath, x0 - k * r * ::sin(a0), y0 - k * r * ::cos(a0), PT_BEZIERTO);
+            AddPathPoint(pMswPath, x3 + k * r * ::sin(a1), y3 + k * r * ::cos(a1), PT_BEZIERTO);
+            AddPathPoint(pMswPath, x3, y3, PT_BEZIERTO);
+            a0 = a1;
+        }
+    }
+
+    static CMswPath *CreateMswPath(const GDCPath &path, float fTolerance)
+    {
+        CMswPath *pMswPath = new CMswPath;
+        pMswPath->m_fTolerance = fTolerance;
+        const std::vector<uint8_t> &verbs   = path.GetVerbs();
+        const std::vector<GDCPoint> &points = path.GetPoints();
+        const std::vector<GDCPathArc> &arcs = path.GetArcs();
+        pMswPath->m_points.reserve(points.size() + arcs.size() * 13);
+        pMswPath->m_types.reserve(points.size() + arcs.size() * 13);
+        size_t iPoint = 0;
+        size_t iArc   = 0;
+
+        bool bFigure = false; // subpath is open
+        bool bClosed = false; // subpath is closed -> next segment starts the new figure at the same point
+        GDCPoint start;
+        std::vector<GDCPoint> flat;
+        for (const uint8_t verb : verbs)
+        {
+            switch ( verb )
+            {
+            case GDC_PATH_MOVE:
+                AddPathPoint(pMswPath, points[iPoint].x, points[iPoint].y, PT_MOVETO);
+                start.x = points[iPoint].x;
+                start.y = points[iPoint].y;
+                ++iPoint;
+                bFigure = true;
+                bClosed = false;
+                break;
+            case GDC_PATH_LINE:
+            case GDC_PATH_ARC:
+                {
+                    GDCPoint pt;
+                    if ( verb == GDC_PATH_LINE ) {
+                        pt.x = points[iPoint].x;
+                        pt.y = points[iPoint].y;
+                        ++iPoint;
+                    }
+                    else {
+                        const GDCPoint arc_start = arcs[iArc].GetStart();
+                        pt.x = arc_start.x;
+                        pt.y = arc_start.y;
+                    }
+                    if ( bClosed ) {
+                        AddPathPoint(pMswPath, start.x, start.y, PT_MOVETO);
+                        bClosed = false;
+                    }
+                    if ( !bFigure ) {
+                        AddPathPoint(pMswPath, pt.x, pt.y, PT_MOVETO);
+                        start.x = pt.x;
+                        start.y = pt.y;
+                        bFigure = true;
+                    }
+                    else if ( verb == GDC_PATH_LINE || pMswPath->m_points.back().x != pt.x || pMswPath->m_points.back().y != pt.y ) {
+                        AddPathPoint(pMswPath, pt.x, pt.y, PT_LINETO);
+                    }
+                    if ( verb == GDC_PATH_ARC ) {
+                        AddPathArc(pMswPath, arcs[iArc++]);
+                    }
+                }
+                break;
+            case GDC_PATH_QUAD:
+            case GDC_PATH_CUBIC:
+                {
+                    const GDCPoint *pCtrl = &points[iPoint];
+                    iPoint += (verb == GDC_PATH_QUAD) ? 2 : 3;
+                    if ( bClosed ) {
+                        AddPathPoint(pMswPath, start.x, start.y, PT_MOVETO);
+                        bClosed = false;
+                    }
+                    if ( !bFigure ) {
+                        AddPathPoint(pMswPath, pCtrl[0].x, pCtrl[0].y, PT_MOVETO); // curve without the start point
+                        start.x = pCtrl[0].x;
+                        start.y = pCtrl[0].y;
+                        bFigure = true;
+                    }
+                    const GDCPoint current(pMswPath->m_points.back().x, pMswPath->m_points.back().y);
+                    flat.clear();
+                    if ( verb == GDC_PATH_QUAD ) {
+                        ::FlattenGdcQuad(current, pCtrl[0], pCtrl[1], fTolerance, flat);
+                    }
+                    else {
+                        ::FlattenGdcCubic(current, pCtrl[0], pCtrl[1], pCtrl[2], fTolerance, flat);
+                    }
+                    for (const GDCPoint &pt : flat) {
+                        AddPathPoint(pMswPath, pt.x, pt.y, PT_LINETO);
+                    }
+                    pMswPath->m_bCurves = true;
+                }
+                break;
+            case GDC_PATH_CLOSE:
+                if ( bFigure && !bClosed ) {
+                    pMswPath->m_types.back() |= PT_CLOSEFIGURE;
+                    bClosed = true;
+                }
+                break;
+            default:
+                ASSERT(FALSE);
+                break;
+            }
+        }
+        return pMswPath;
+    }
+};
+
+void CMswGDC::DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint)
+{
+    if ( path.m_pMswPath && static_cast<const CMswPath *>(path.m_pMswPath)->m_bCurves &&
+         static_cast<const CMswPath *>(path.m_pMswPath)->m_fTolerance != m_fCurveTolerance ) {
+        delete path.m_pMswPath; // zoom changed -> curves are flattened again
+        path.m_pMswPath = nullptr;
+    }
+    if ( !path.m_pMswPath ) {
+        path.m_pMswPath = internal::CreateMswPath(path, m_fCurveTolerance);
+    }
+    const CMswPath *pMswPath = static_cast<const CMswPath *>(path.m_pMswPath);
+    ASSERT(pFillPaint || pStrokePaint);
+    if ( pMswPath->m_points.empty() || (!pFillPaint && !pStrokePaint) ) {
+        return;
+    }
+
+    if ( pStrokePaint ) {
+        ODCInit::SelectStrokePaint(m_pDC, *pStrokePaint);
+    }
+    OBrush brush(NULL_BRUSH);
+    if ( pFillPaint ) {
+        ODCInit::SelectFillPaint(m_pDC, *pFillPaint);
+    }
+    else {
+        m_pDC->SelectObject(&brush);
+    }
+    ODCInit::CBinaryRaster rop2(m_pDC, pFillPaint ? *pFillPaint : *pStrokePaint);
+
+    const HDC hDC = m_pDC->GetSafeHdc();
+    const int32_t nOldMode = ::SetPolyFillMode(hDC, path.GetFillRule() == GDC_FILL_RULE_EVENODD ? ALTERNATE : WINDING);
+    ::BeginPath(hDC);
+    ::PolyDraw(hDC, pMswPath->m_points.data(), pMswPath->m_types.data(), (int32_t)pMswPath->m_points.size());
+    ::EndPath(hDC);
+    if ( pFillPaint && pStrokePaint ) {
+        ::StrokeAndFillPath(hDC);
+    }
+    else if ( pFillPaint ) {
+        ::FillPath(hDC);
+    }
+    else {
+        ::StrokePath(hDC);
+    }
+    ::SetPolyFillMode(hDC, nOldMode);
+}
+
 void CMswGDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
     ODCInit::SelectStrokePaint(m_pDC, paint);
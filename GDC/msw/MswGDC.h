@@ -26,18 +26,26 @@ public:
     virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
     virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override;
     
-    virtual void DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
-    virtual void DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) override; // closed line => polygon
-    virtual void DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override; // closed line => polygon
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override;
     
-    virtual void DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint) override;
-    virtual void DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude, 
                                     const wchar_t *sTexturePath, double dAngle, float fZoom) override;
 
     virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override;
     virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override;
     
     virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
     virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
@@ -61,14 +69,23 @@ public:
     virtual void SetViewportOrg(int32_t x, int32_t y) override;
     virtual GDCPoint GetViewportOrg() const override;
 
+    virtual void SetCurveTolerance(float fTolerance) override { m_fCurveTolerance = fTolerance; }
+
     virtual HDC GetHDC() override; // platform specific (must be used only for the transitional code)
 
     virtual void BeginGroup(const char *sGroupAttributes) override { }
     virtual void EndGroup() override { } 
 
+private:
+    // packed points are passed as is, others are copied into the m_points
+    const POINT *GetPOINTs(const GDCPoints &points);
+
 // Attributes
 private:
     ODC *m_pDC;
+    std::vector<POINT> m_points; // capacity is reused
+    std::vector<DWORD> m_counts; // PolyPolyline
+    float m_fCurveTolerance {GDC_CURVE_TOLERANCE};
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef __MSW_PATH_H__
+#define __MSW_PATH_H__
+#pragma once
+
+#ifndef __ABS_PATH_H__
+    #include "../AbsPath.h"
+#endif
+
+#include "vector"
+
+// GDCPath prepared by the CMswGDC: ::PolyDraw points and types, arcs as the bezier segments,
+// bezier curves are flattened with the m_fTolerance
+class CMswPath final : public CAbsPath
+{
+// Construction/Destruction
+public:
+    CMswPath() { }
+    virtual ~CMswPath() { }
+
+// Attributes
+public:
+    std::vector<POINT> m_points;
+    std::vector<BYTE> m_types;
+    bool m_bCurves {false};
+    float m_fTolerance {0.f};
+};
+
+#endif
@@ -18,7 +18,7 @@
 
 namespace gdi_plus_internal
 {
-    static void DoDrawPolygonTransparent(HDC hDC, Gdiplus::Point *points, int32_t nSize,
+    static void DoDrawPolygonTransparent(HDC hDC, const Gdiplus::Point *points, int32_t nSize,
                                          unsigned char alfa, unsigned char r, unsigned char g, unsigned char b)
     {
         Gdiplus::GraphicsPath path;
@@ -31,21 +31,38 @@ namespace gdi_plus_internal
         dc.FillRegion(&brush, &region);
     }
 
-    static Gdiplus::Point *Poly2GdiPlus2(const std::vector<POINT> &poly)
+    // Gdiplus::Point has the same layout as POINT -> no copy
+    static inline const Gdiplus::Point *Poly2GdiPlus(const POINT *pPoints)
     {
-        const size_t nCnt = poly.size();
-        ASSERT(nCnt > 0);
+        static_assert(sizeof(Gdiplus::Point) == sizeof(POINT), "Gdiplus::Point layout");
+        return reinterpret_cast<const Gdiplus::Point *>(pPoints);
+    }
 
-        Gdiplus::Point *points = new Gdiplus::Point[nCnt];
-        POINT pt;
-        for (size_t i1 = 0; i1 < nCnt; ++i1)
+    // float x, y pairs are passed as is
+    static inline const Gdiplus::PointF *PolyF2GdiPlus(const float *pXY)
+    {
+        static_assert(sizeof(Gdiplus::PointF) == 2 * sizeof(float), "Gdiplus::PointF layout");
+        return reinterpret_cast<const Gdiplus::PointF *>(pXY);
+    }
+
+    // GDCStrokeType -> dash pattern, nullptr for the solid line
+    static const Gdiplus::REAL *GetDashPattern(int32_t nDashStyle, int32_t &nCount)
+    {
+        static const Gdiplus::REAL dash[2]          = { 18, 6 };
+        static const Gdiplus::REAL dot[2]           = { 3, 3 };
+        static const Gdiplus::REAL dash_dot[4]      = { 9, 6, 3, 6 };
+        static const Gdiplus::REAL dash_dot_dot[6]  = { 9, 3, 3, 3, 3, 3 };
+        switch ( nDashStyle )
         {
-            pt = poly[i1];
-            points[i1].X = pt.x;
-            points[i1].Y = pt.y;
+        case 1: nCount = 2; return dash;
+        case 2: nCount = 2; return dot;
+        case 3: nCount = 4; return dash_dot;
+        case 4: nCount = 6; return dash_dot_dot;
+        default:
+            break;
         }
-
-        return points;
+        nCount = 0;
+        return nullptr;
     }
 
     static void DrawLine(HDC hDC, int32_t x1, int32_t y1, int32_t x2, int32_t y2, unsigned char init_r, unsigned char init_g, unsigned char init_b,
@@ -58,12 +75,11 @@ namespace gdi_plus_internal
     }
 };
 
-void CGdiPlusUtil::DrawPolygonTransparent(HDC hDC, const std::vector<POINT> &poly,
+void CGdiPlusUtil::DrawPolygonTransparent(HDC hDC, const POINT *pPoints, size_t nCount,
                                           unsigned char alfa, unsigned char r, unsigned char g, unsigned char b)
 {
-    Gdiplus::Point *points = gdi_plus_internal::Poly2GdiPlus2(poly);
-    gdi_plus_internal::DoDrawPolygonTransparent(hDC, points, (int32_t)poly.size(), alfa, r, g, b);
-    delete [] points;
+    ASSERT(nCount > 0);
+    gdi_plus_internal::DoDrawPolygonTransparent(hDC, gdi_plus_internal::Poly2GdiPlus(pPoints), (int32_t)nCount, alfa, r, g, b);
 }
 
 void CGdiPlusUtil::DrawLineDash(HDC hDC, int32_t x1, int32_t y1, int32_t x2, int32_t y2, unsigned char init_r, unsigned char init_g, unsigned char init_b, double dWidth)
@@ -90,38 +106,62 @@ void CGdiPlusUtil::DrawLineDashDotDot(HDC hDC, int32_t x1, int32_t y1, int32_t x
     gdi_plus_internal::DrawLine(hDC, x1, y1, x2, y2, init_r, init_g, init_b, dWidth, dashValues, 6);
 }
 
-void CGdiPlusUtil::DrawPolygon(HDC hDC, const std::vector<POINT> &poly,
+void CGdiPlusUtil::DrawPolyLineF(HDC hDC, const float *pXY, size_t nCount, bool bClose, int32_t nDashStyle, double dWidth,
+                                 unsigned char alfa, unsigned char r, unsigned char g, unsigned char b)
+{
+    ASSERT(nCount > 0);
+    Gdiplus::Graphics dc(hDC);
+    dc.SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
+    Gdiplus::Pen pen(Gdiplus::Color(alfa, r, g, b), (Gdiplus::REAL)dWidth);
+    int32_t nDashes = 0;
+    const Gdiplus::REAL *pDashes = gdi_plus_internal::GetDashPattern(nDashStyle, nDashes);
+    if ( pDashes ) {
+        pen.SetDashPattern(pDashes, nDashes);
+    }
+    if ( bClose ) {
+        dc.DrawPolygon(&pen, gdi_plus_internal::PolyF2GdiPlus(pXY), (INT)nCount);
+    }
+    else {
+        dc.DrawLines(&pen, gdi_plus_internal::PolyF2GdiPlus(pXY), (INT)nCount);
+    }
+}
+
+void CGdiPlusUtil::FillPolygonF(HDC hDC, const float *pXY, size_t nCount,
+                                unsigned char alfa, unsigned char r, unsigned char g, unsigned char b)
+{
+    ASSERT(nCount > 0);
+    Gdiplus::Graphics dc(hDC);
+    dc.SetSmoothingMode(Gdiplus::SmoothingModeAntiAlias);
+    Gdiplus::SolidBrush brush(Gdiplus::Color(alfa, r, g, b));
+    dc.FillPolygon(&brush, gdi_plus_internal::PolyF2GdiPlus(pXY), (INT)nCount);
+}
+
+void CGdiPlusUtil::DrawPolygon(HDC hDC, const POINT *pPoints, size_t nCount,
                                unsigned char init_r, unsigned char init_g, unsigned char init_b,
                                unsigned char dest_r, unsigned char dest_g, unsigned char dest_b)
 {
-    const size_t nCnt = poly.size();
+    const size_t nCnt = nCount;
     ASSERT(nCnt > 0);
 
-    Gdiplus::Point *points = new Gdiplus::Point[nCnt];
-
-    points[0].X = poly[0].x;
-    points[0].Y = poly[0].y;
+    const Gdiplus::Point *points = gdi_plus_internal::Poly2GdiPlus(pPoints);
 
     Gdiplus::Point pt_max(points[0]);
     Gdiplus::Point pt_min(points[0]);
 
     for (size_t i1 = 1; i1 < nCnt; ++i1)
     {
-        points[i1].X = poly[i1].x;
-        points[i1].Y = poly[i1].y;
-
-        if (pt_max.X < poly[i1].x) {
-            pt_max.X = poly[i1].x;
+        if (pt_max.X < points[i1].X) {
+            pt_max.X = points[i1].X;
         }
-        if (pt_max.Y < poly[i1].y) {
-            pt_max.Y = poly[i1].y;
+        if (pt_max.Y < points[i1].Y) {
+            pt_max.Y = points[i1].Y;
         }
 
-        if (pt_min.X > poly[i1].x) {
-            pt_min.X = poly[i1].x;
+        if (pt_min.X > points[i1].X) {
+            pt_min.X = points[i1].X;
         }
-        if (pt_min.Y > poly[i1].y) {
-            pt_min.Y = poly[i1].y;
+        if (pt_min.Y > points[i1].Y) {
+            pt_min.Y = points[i1].Y;
         }
     }
 
@@ -138,6 +178,4 @@ void CGdiPlusUtil::DrawPolygon(HDC hDC, const std::vector<POINT> &poly,
         Gdiplus::Color(255, init_r, init_g, init_b),
         Gdiplus::Color(255, dest_r, dest_g, dest_b));
     dc.FillPolygon(&linGrBrush, points, (int)nCnt);
-
-    delete[] points;
 }
@@ -8,11 +8,11 @@ class CGdiPlusUtil
 {
 // Static operations
 public:
-    static void DrawPolygon(HDC hDC, const std::vector<POINT> &poly,
+    static void DrawPolygon(HDC hDC, const POINT *pPoints, size_t nCount,
                             unsigned char init_r, unsigned char init_g, unsigned char init_b,
                             unsigned char dest_r, unsigned char dest_g, unsigned char dest_b);
 
-    static void DrawPolygonTransparent(HDC hDC, const std::vector<POINT> &poly,
+    static void DrawPolygonTransparent(HDC hDC, const POINT *pPoints, size_t nCount,
                                        unsigned char alfa, unsigned char r, unsigned char g, unsigned char b);
 
     static void DrawLineDash(HDC hDC, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
@@ -23,6 +23,12 @@ public:
                                 unsigned char init_r, unsigned char init_g, unsigned char init_b, double dWidth);
     static void DrawLineDashDotDot(HDC hDC, int32_t x1, int32_t y1, int32_t x2, int32_t y2,
                                    unsigned char init_r, unsigned char init_g, unsigned char init_b, double dWidth);
+
+    // sub-pixel coordinates, anti-aliased: pXY - interleaved x, y; nDashStyle - GDCStrokeType
+    static void DrawPolyLineF(HDC hDC, const float *pXY, size_t nCount, bool bClose, int32_t nDashStyle, double dWidth,
+                              unsigned char alfa, unsigned char r, unsigned char g, unsigned char b);
+    static void FillPolygonF(HDC hDC, const float *pXY, size_t nCount,
+                             unsigned char alfa, unsigned char r, unsigned char g, unsigned char b);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include "stdafx.h"
+#include "HashGDC.h"
+
+#include "ListOps.h"
+#include "ListStream.h"
+#include "ListResources.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+uint64_t CHashGDC::HashBytes(const void *pData, size_t nSize)
+{
+    uint64_t nHash = 0xCBF29CE484222325ULL;
+    const uint8_t *pBytes = (const uint8_t *)pData;
+    for (size_t i = 0; i < nSize; ++i) {
+        nHash = Combine(nHash, pBytes[i]);
+    }
+    return nHash;
+}
+
+void CHashGDC::Reset()
+{
+    m_nHash = 0xCBF29CE484222325ULL;
+    if ( m_org.x != 0 || m_org.y != 0 ) {
+        AddInt(m_org.x);
+        AddInt(m_org.y);
+    }
+}
+
+void CHashGDC::SetViewportOrg(int32_t x, int32_t y)
+{
+    Add(GDC_LIST_VIEWPORT_ORG);
+    AddInt(x);
+    AddInt(y);
+    m_org.x = x;
+    m_org.y = y;
+}
+
+void CHashGDC::AddFloat(float fValue)
+{
+    uint32_t nBits = 0;
+    ::memcpy(&nBits, &fValue, sizeof(nBits));
+    Add(nBits);
+}
+
+void CHashGDC::AddDouble(double dValue)
+{
+    uint64_t nBits = 0;
+    ::memcpy(&nBits, &dValue, sizeof(nBits));
+    Add(nBits);
+}
+
+void CHashGDC::AddString(const wchar_t *sValue)
+{
+    const size_t nLen = sValue ? ::wcslen(sValue) : 0;
+    Add(nLen);
+    for (size_t i = 0; i < nLen; ++i) {
+        Add((uint64_t)sValue[i]);
+    }
+}
+
+void CHashGDC::AddPoints(const GDCPoints &points)
+{
+    Add(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        Add(((uint64_t)(uint32_t)points.X(i) << 32) | (uint32_t)points.Y(i));
+    }
+}
+
+void CHashGDC::AddPointsF(const GDCPointF *pPoints, size_t nCount)
+{
+    Add(nCount);
+    for (size_t i = 0; i < nCount; ++i) {
+        AddFloat(pPoints[i].x);
+        AddFloat(pPoints[i].y);
+    }
+}
+
+void CHashGDC::AddPaint(const GDCPaint &paint)
+{
+    auto found = m_object_hashes.find(&paint);
+    if ( found == m_object_hashes.end() ) {
+        m_object.clear();
+        CListWriter writer(m_object);
+        CListResources::WritePaint(writer, paint);
+        found = m_object_hashes.emplace(&paint, HashBytes(m_object.data(), m_object.size())).first;
+    }
+    Add(found->second);
+}
+
+void CHashGDC::AddPath(const GDCPath &path)
+{
+    auto found = m_object_hashes.find(&path);
+    if ( found == m_object_hashes.end() ) {
+        m_object.clear();
+        CListWriter writer(m_object);
+        CListResources::WritePath(writer, path);
+        found = m_object_hashes.emplace(&path, HashBytes(m_object.data(), m_object.size())).first;
+    }
+    Add(found->second);
+}
+
+void CHashGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    Add(GDC_LIST_LINE);
+    AddPaint(paint);
+    AddInt(x1); AddInt(y1); AddInt(x2); AddInt(y2);
+}
+
+void CHashGDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint)
+{
+    Add(GDC_LIST_POINT);
+    AddPaint(paint);
+    AddInt(x); AddInt(y);
+}
+
+void CHashGDC::DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_POLYGON);
+    AddPaint(fill_paint);
+    AddPaint(stroke_paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_POLY);
+    AddPaint(stroke_paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_POLYLINE);
+    AddPaint(stroke_paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)
+{
+    Add(GDC_LIST_POLYGON_TRANSPARENT);
+    AddPaint(fill_paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
+{
+    Add(GDC_LIST_POLYGON_GRADIENT);
+    AddPaint(paintFrom);
+    AddPaint(paintTo);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    Add(GDC_LIST_POLYGON_TEXTURE);
+    AddString(sTexturePath);
+    AddDouble(dAngle);
+    AddFloat(fZoom);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                  const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    Add(GDC_LIST_POLYGON_TEXTURE_EXCLUDE);
+    AddString(sTexturePath);
+    AddDouble(dAngle);
+    AddFloat(fZoom);
+    AddPoints(points);
+    AddPoints(points_exclude);
+}
+
+void CHashGDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint)
+{
+    Add(GDC_LIST_FILLED_RECTANGLE);
+    AddPaint(fill_paint);
+    AddInt(x1); AddInt(y1); AddInt(x2); AddInt(y2);
+}
+
+void CHashGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_RECTANGLE);
+    AddPaint(stroke_paint);
+    AddInt(x1); AddInt(y1); AddInt(x2); AddInt(y2);
+}
+
+void CHashGDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    Add(GDC_LIST_LINES);
+    AddPaint(paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_RECTS);
+    AddPaint(stroke_paint);
+    AddPoints(corners);
+}
+
+void CHashGDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    Add(GDC_LIST_POINTS);
+    AddPaint(paint);
+    AddPoints(points);
+}
+
+void CHashGDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    Add(GDC_LIST_LINE_F);
+    AddPaint(paint);
+    AddFloat(x1); AddFloat(y1); AddFloat(x2); AddFloat(y2);
+}
+
+void CHashGDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_POLYLINE_F);
+    AddPaint(stroke_paint);
+    AddPointsF(pPoints, nCount);
+}
+
+void CHashGDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    Add(GDC_LIST_POLYGON_F);
+    AddPaint(fill_paint);
+    AddPaint(stroke_paint);
+    AddPointsF(pPoints, nCount);
+}
+
+void CHashGDC::DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint)
+{
+    Add(GDC_LIST_PATH);
+    AddPath(path);
+    Add((pFillPaint ? 1 : 0) | (pStrokePaint ? 2 : 0));
+    if ( pFillPaint ) {
+        AddPaint(*pFillPaint);
+    }
+    if ( pStrokePaint ) {
+        AddPaint(*pStrokePaint);
+    }
+}
+
+void CHashGDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    Add(GDC_LIST_ELLIPSE);
+    AddPaint(paint);
+    AddInt(x1); AddInt(y1); AddInt(x2); AddInt(y2);
+}
+
+void CHashGDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    Add(GDC_LIST_FILLED_ELLIPSE);
+    AddPaint(paint);
+    AddInt(x1); AddInt(y1); AddInt(x2); AddInt(y2);
+}
+
+void CHashGDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint)
+{
+    Add(GDC_LIST_HOLLOW_OVAL);
+    AddPaint(fill_paint);
+    AddInt(xCenter); AddInt(yCenter); AddInt(rx); AddInt(ry); AddInt(h);
+}
+
+void CHashGDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint)
+{
+    Add(GDC_LIST_ARC);
+    AddPaint(paint);
+    AddInt(x); AddInt(y); AddInt(nRadius);
+    AddFloat(fStartAngle);
+    AddFloat(fSweepAngle);
+}
+
+void CHashGDC::DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y)
+{
+    // bitmap content is not known: the same handle is the same picture
+    Add(GDC_LIST_BITMAP);
+    Add((uint64_t)(uintptr_t)hBitmap);
+    AddInt(x); AddInt(y);
+}
+
+void CHashGDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint)
+{
+    Add(GDC_LIST_TEXT_OUT);
+    AddPaint(paint);
+    AddString(sText);
+    AddInt(x); AddInt(y);
+}
+
+void CHashGDC::DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
+{
+    Add(GDC_LIST_DRAW_TEXT);
+    AddPaint(paint);
+    AddString(sText);
+    AddInt(rect.left); AddInt(rect.top); AddInt(rect.right); AddInt(rect.bottom);
+}
+
+void CHashGDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                 const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint)
+{
+    Add(GDC_LIST_TEXT_BY_ELLIPSE);
+    AddPaint(paint);
+    AddString(sText);
+    AddDouble(dCenterAngle);
+    AddInt(nRadiusX); AddInt(nRadiusY); AddInt(xCenter); AddInt(yCenter);
+    AddDouble(dEllipseAngleRad);
+}
+
+void CHashGDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                bool bRevertTextDir, const GDCPaint &paint)
+{
+    Add(GDC_LIST_TEXT_BY_CIRCLE);
+    AddPaint(paint);
+    AddString(sText);
+    AddDouble(dCenterAngle);
+    AddInt(nRadius); AddInt(nCX); AddInt(nCY);
+    Add(bRevertTextDir ? 1 : 0);
+}
@@ -0,0 +1,116 @@
+#ifndef __HASH_GDC_H__
+#define __HASH_GDC_H__
+#pragma once
+
+#ifndef __ABS_GDC_H__
+    #include "../AbsGDC.h"
+#endif
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+#include "vector"
+#include "unordered_map"
+
+// Backend which hashes the calls instead of drawing: paints and paths by the value, coordinates as passed
+// -> equal drawing gives the equal hash in any display list (ids and delta coding do not matter).
+class CHashGDC final : public CAbsGDC
+{
+// Construction/Destruction
+public:
+    CHashGDC() { }
+    virtual ~CHashGDC() { }
+
+private:
+    CHashGDC(const CHashGDC &gdc);
+
+// Static operations
+public:
+    static uint64_t Combine(uint64_t nHash, uint64_t nValue) {
+        return (nHash ^ nValue) * 0x100000001B3ULL; // FNV prime
+    }
+    static uint64_t HashBytes(const void *pData, size_t nSize);
+
+// Operations
+public:
+    // hash of the calls since the previous Reset
+    uint64_t GetHash() const { return m_nHash; }
+    // viewport origin is kept -> the next calls are hashed with the origin they are drawn with
+    void Reset();
+
+// Overrides
+public:
+    virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override;
+
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                    const wchar_t *sTexturePath, double dAngle, float fZoom) override;
+
+    virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override;
+    virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override;
+
+    virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint) override;
+    virtual void DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint) override;
+
+    virtual void DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y) override;
+
+    virtual void TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint) override;
+    virtual void DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint) override;
+    virtual void DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                   const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint) override;
+    virtual void DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                  bool bRevertTextDir, const GDCPaint &paint) override;
+
+    // nothing is measured
+    virtual int32_t GetTextHeight(const GDCPaint &paint) const override { return 0; }
+    virtual GDCSize GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const override { return GDCSize(); }
+
+    virtual void SetViewportOrg(int32_t x, int32_t y) override;
+    virtual GDCPoint GetViewportOrg() const override           { return m_org; }
+
+    virtual void SetCurveTolerance(float fTolerance) override  { }
+
+    virtual void BeginGroup(const char *sGroupAttributes) override { }
+    virtual void EndGroup() override { }
+
+    virtual HDC GetHDC() override { return nullptr; }
+
+private:
+    void Add(uint64_t nValue) { m_nHash = Combine(m_nHash, nValue); }
+    void AddInt(int64_t nValue) { Add((uint64_t)nValue); }
+    void AddFloat(float fValue);
+    void AddDouble(double dValue);
+    void AddString(const wchar_t *sValue);
+    void AddPoints(const GDCPoints &points);
+    void AddPointsF(const GDCPointF *pPoints, size_t nCount);
+    // replayed objects live as long as the display list -> hashes are cached by the address
+    void AddPaint(const GDCPaint &paint);
+    void AddPath(const GDCPath &path);
+
+// Attributes
+private:
+    uint64_t m_nHash {0xCBF29CE484222325ULL}; // FNV offset basis
+    GDCPoint m_org;
+    std::unordered_map<const void *, uint64_t> m_object_hashes;
+    std::vector<uint8_t> m_object; // serialized paint or path
+};
+
+#endif
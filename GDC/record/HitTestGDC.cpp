@@ -0,0 +1,519 @@
+#include "stdafx.h"
+#include "HitTestGDC.h"
+
+#include "../GDC.h"
+
+#include "math.h"
+#include "algorithm"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define HIT_TEST_PI 3.1415926535897932384626433832795
+
+namespace internal
+{
+    // GDCPoints interface over the float points
+    class CHitPointsF final
+    {
+    // Construction/Destruction
+    public:
+        CHitPointsF(const GDCPointF *pPoints, size_t nCount) : m_pPoints(pPoints), m_nCount(nCount) { }
+        ~CHitPointsF() { }
+
+    // Operations
+    public:
+        size_t size() const     { return m_nCount; }
+        float X(size_t i) const { return m_pPoints[i].x; }
+        float Y(size_t i) const { return m_pPoints[i].y; }
+
+    // Attributes
+    private:
+        const GDCPointF *m_pPoints;
+        size_t m_nCount;
+    };
+
+    static inline double GetSegmentDistance2(double x, double y, double x1, double y1, double x2, double y2)
+    {
+        const double dx = x2 - x1;
+        const double dy = y2 - y1;
+        const double dLength2 = dx * dx + dy * dy;
+        double t = 0.;
+        if ( dLength2 > 0. ) {
+            t = ((x - x1) * dx + (y - y1) * dy) / dLength2;
+            t = t < 0. ? 0. : (t > 1. ? 1. : t);
+        }
+        const double ex = x1 + t * dx - x;
+        const double ey = y1 + t * dy - y;
+        return ex * ex + ey * ey;
+    }
+
+    // squared distance to the polyline [nFirst, nEnd)
+    template <class TPoints>
+    static double GetPolyDistance2(const TPoints &points, size_t nFirst, size_t nEnd, bool bClosed, double x, double y)
+    {
+        if ( nFirst >= nEnd ) {
+            return HUGE_VAL;
+        }
+        double dMin = GetSegmentDistance2(x, y, points.X(nFirst), points.Y(nFirst), points.X(nFirst), points.Y(nFirst));
+        for (size_t i = nFirst + 1; i < nEnd; ++i) {
+            dMin = (std::min)(dMin, GetSegmentDistance2(x, y, points.X(i - 1), points.Y(i - 1), points.X(i), points.Y(i)));
+        }
+        if ( bClosed ) {
+            dMin = (std::min)(dMin, GetSegmentDistance2(x, y, points.X(nEnd - 1), points.Y(nEnd - 1), points.X(nFirst), points.Y(nFirst)));
+        }
+        return dMin;
+    }
+
+    // winding number of the ring [nFirst, nEnd) around the point (odd -> inside with the even-odd rule)
+    template <class TPoints>
+    static int32_t GetWinding(const TPoints &points, size_t nFirst, size_t nEnd, double x, double y)
+    {
+        int32_t nWinding = 0;
+        if ( nEnd - nFirst < 3 || nFirst >= nEnd ) {
+            return nWinding;
+        }
+        size_t iPrev = nEnd - 1;
+        for (size_t i = nFirst; i < nEnd; iPrev = i++) {
+            const double x1 = points.X(iPrev);
+            const double y1 = points.Y(iPrev);
+            const double x2 = points.X(i);
+            const double y2 = points.Y(i);
+            const double dSide = (x2 - x1) * (y - y1) - (x - x1) * (y2 - y1);
+            if ( y1 <= y ) {
+                if ( y2 > y && dSide > 0. ) {
+                    ++nWinding;
+                }
+            }
+            else if ( y2 <= y && dSide < 0. ) {
+                --nWinding;
+            }
+        }
+        return nWinding;
+    }
+
+    // filled polygon (even-odd as GDI ALTERNATE) or its outline within the dReach
+    template <class TPoints>
+    static bool IsPolygonHit(const TPoints &points, double x, double y, double dReach)
+    {
+        if ( GetWinding(points, 0, points.size(), x, y) & 1 ) {
+            return true;
+        }
+        return GetPolyDistance2(points, 0, points.size(), true, x, y) <= dReach * dReach;
+    }
+
+    template <class TPoints>
+    static bool IsPolyHit(const TPoints &points, bool bClosed, double x, double y, double dReach)
+    {
+        return GetPolyDistance2(points, 0, points.size(), bClosed, x, y) <= dReach * dReach;
+    }
+
+    static inline bool IsRectHit(double x, double y, double x1, double y1, double x2, double y2, double dReach)
+    {
+        return x >= (std::min)(x1, x2) - dReach && x <= (std::max)(x1, x2) + dReach &&
+               y >= (std::min)(y1, y2) - dReach && y <= (std::max)(y1, y2) + dReach;
+    }
+
+    // angle (degrees) is within the sweep from the start, negative sweep goes backwards
+    static bool IsAngleInSweep(double dAngle, double dStartAngle, double dSweepAngle)
+    {
+        if ( ::fabs(dSweepAngle) >= 360. ) {
+            return true;
+        }
+        double dFromStart = ::fmod(dAngle - dStartAngle, 360.);
+        if ( dSweepAngle < 0. ) {
+            dFromStart = -dFromStart;
+        }
+        if ( dFromStart < 0. ) {
+            dFromStart += 360.;
+        }
+        return dFromStart <= ::fabs(dSweepAngle);
+    }
+
+    static bool IsRectOutlineHit(double x, double y, double x1, double y1, double x2, double y2, double dReach)
+    {
+        const double dReach2 = dReach * dReach;
+        return GetSegmentDistance2(x, y, x1, y1, x2, y1) <= dReach2 || GetSegmentDistance2(x, y, x2, y1, x2, y2) <= dReach2 ||
+               GetSegmentDistance2(x, y, x2, y2, x1, y2) <= dReach2 || GetSegmentDistance2(x, y, x1, y2, x1, y1) <= dReach2;
+    }
+};
+
+CHitTestGDC::CHitTestGDC(int32_t x, int32_t y, int32_t nTolerance)
+: m_xTest(x), m_yTest(y), m_x(x), m_y(y), m_dTolerance(::abs(nTolerance))
+{
+
+}
+
+void CHitTestGDC::SetViewportOrg(int32_t x, int32_t y)
+{
+    m_org.x = x;
+    m_org.y = y;
+    m_x = (double)m_xTest - x;
+    m_y = (double)m_yTest - y;
+}
+
+double CHitTestGDC::GetStrokeReach(const GDCPaint &paint) const
+{
+    return m_dTolerance + (std::max)(paint.GetStrokeWidth(), 1.f) * 0.5;
+}
+
+bool CHitTestGDC::IsInEllipse(double xCenter, double yCenter, double rx, double ry, double dExtent) const
+{
+    rx += dExtent;
+    ry += dExtent;
+    if ( rx <= 0. || ry <= 0. ) {
+        return false;
+    }
+    const double dx = (m_x - xCenter) / rx;
+    const double dy = (m_y - yCenter) / ry;
+    return dx * dx + dy * dy <= 1.;
+}
+
+void CHitTestGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const double dReach = GetStrokeReach(paint);
+    m_bHit |= internal::GetSegmentDistance2(m_x, m_y, x1, y1, x2, y2) <= dReach * dReach;
+}
+
+void CHitTestGDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint)
+{
+    const double dReach = m_dTolerance + paint.GetStrokeWidth() + 1.;
+    m_bHit |= internal::GetSegmentDistance2(m_x, m_y, x, y, x, y) <= dReach * dReach;
+}
+
+void CHitTestGDC::DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsPolygonHit(points, m_x, m_y, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsPolyHit(points, true, m_x, m_y, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsPolyHit(points, false, m_x, m_y, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)
+{
+    m_bHit |= internal::IsPolygonHit(points, m_x, m_y, m_dTolerance);
+}
+
+void CHitTestGDC::DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
+{
+    m_bHit |= internal::IsPolygonHit(points, m_x, m_y, m_dTolerance);
+}
+
+void CHitTestGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    m_bHit |= internal::IsPolygonHit(GDCPoints(points), m_x, m_y, m_dTolerance);
+}
+
+void CHitTestGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                     const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    const GDCPoints exclude(points_exclude);
+    if ( (internal::GetWinding(exclude, 0, exclude.size(), m_x, m_y) & 1) &&
+         internal::GetPolyDistance2(exclude, 0, exclude.size(), true, m_x, m_y) > m_dTolerance * m_dTolerance ) {
+        return; // inside of the hole
+    }
+    m_bHit |= internal::IsPolygonHit(GDCPoints(points), m_x, m_y, m_dTolerance);
+}
+
+void CHitTestGDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint)
+{
+    m_bHit |= internal::IsRectHit(m_x, m_y, x1, y1, x2, y2, m_dTolerance);
+}
+
+void CHitTestGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsRectOutlineHit(m_x, m_y, x1, y1, x2, y2, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    const double dReach2 = GetStrokeReach(paint) * GetStrokeReach(paint);
+    for (size_t i = 1; i < points.size() && !m_bHit; i += 2) {
+        m_bHit = internal::GetSegmentDistance2(m_x, m_y, points.X(i - 1), points.Y(i - 1), points.X(i), points.Y(i)) <= dReach2;
+    }
+}
+
+void CHitTestGDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    const double dReach = GetStrokeReach(stroke_paint);
+    for (size_t i = 1; i < corners.size() && !m_bHit; i += 2) {
+        m_bHit = internal::IsRectOutlineHit(m_x, m_y, corners.X(i - 1), corners.Y(i - 1), corners.X(i), corners.Y(i), dReach);
+    }
+}
+
+void CHitTestGDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    const double dReach = m_dTolerance + paint.GetStrokeWidth() + 1.;
+    for (size_t i = 0; i < points.size() && !m_bHit; ++i) {
+        m_bHit = internal::GetSegmentDistance2(m_x, m_y, points.X(i), points.Y(i), points.X(i), points.Y(i)) <= dReach * dReach;
+    }
+}
+
+void CHitTestGDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    const double dReach = GetStrokeReach(paint);
+    m_bHit |= internal::GetSegmentDistance2(m_x, m_y, x1, y1, x2, y2) <= dReach * dReach;
+}
+
+void CHitTestGDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsPolyHit(internal::CHitPointsF(pPoints, nCount), false, m_x, m_y, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    m_bHit |= internal::IsPolygonHit(internal::CHitPointsF(pPoints, nCount), m_x, m_y, GetStrokeReach(stroke_paint));
+}
+
+void CHitTestGDC::FlattenPath(const GDCPath &path)
+{
+    m_points.clear();
+    m_ends.clear();
+    m_closed.clear();
+
+    const std::vector<GDCPoint> &points = path.GetPoints();
+    const std::vector<GDCPathArc> &arcs = path.GetArcs();
+    size_t iPoint = 0;
+    size_t iArc   = 0;
+    size_t nBegin = 0; // current subpath
+    auto EndSubpath = [&](bool bClosed) {
+        if ( m_points.size() > nBegin ) {
+            m_ends.push_back(m_points.size());
+            m_closed.push_back(bClosed ? 1 : 0);
+        }
+        nBegin = m_points.size();
+    };
+    for (const uint8_t verb : path.GetVerbs()) {
+        switch (verb)
+        {
+        case GDC_PATH_MOVE:
+            EndSubpath(false);
+            m_points.push_back(points[iPoint++]);
+            break;
+        case GDC_PATH_LINE:
+            m_points.push_back(points[iPoint++]);
+            break;
+        case GDC_PATH_QUAD:
+            if ( m_points.size() > nBegin ) {
+                ::FlattenGdcQuad(m_points.back(), points[iPoint], points[iPoint + 1], GDC_CURVE_TOLERANCE, m_points);
+            }
+            iPoint += 2;
+            break;
+        case GDC_PATH_CUBIC:
+            if ( m_points.size() > nBegin ) {
+                ::FlattenGdcCubic(m_points.back(), points[iPoint], points[iPoint + 1], points[iPoint + 2], GDC_CURVE_TOLERANCE, m_points);
+            }
+            iPoint += 3;
+            break;
+        case GDC_PATH_ARC:
+            {
+                const GDCPathArc &arc = arcs[iArc++];
+                // chords deviate from the circle up to the curve tolerance
+                const double dRadius = (std::max)((double)::abs(arc.m_nRadius), (double)GDC_CURVE_TOLERANCE);
+                const double dStep   = 2. * ::acos(1. - GDC_CURVE_TOLERANCE / dRadius) * 180. / HIT_TEST_PI;
+                const size_t nSteps  = (size_t)(std::min)(::ceil(::fabs(arc.m_fSweepAngle) / dStep), 1024.);
+                for (size_t i = 0; i <= nSteps; ++i) {
+                    const float fFraction = nSteps ? (float)i / nSteps : 0.f;
+                    m_points.push_back(arc.GetPoint(arc.m_fStartAngle + arc.m_fSweepAngle * fFraction));
+                }
+            }
+            break;
+        case GDC_PATH_CLOSE:
+            {
+                const GDCPoint start = m_points.size() > nBegin ? m_points[nBegin] : GDCPoint();
+                const bool bSubpath  = m_points.size() > nBegin;
+                EndSubpath(true);
+                if ( bSubpath ) { // next segment starts at the subpath start
+                    m_points.push_back(start);
+                }
+            }
+            break;
+        default:
+            ASSERT(FALSE);
+            break;
+        }
+    }
+    EndSubpath(false);
+}
+
+void CHitTestGDC::DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint)
+{
+    FlattenPath(path);
+    const GDCPoints points(m_points);
+    if ( pFillPaint ) {
+        int32_t nWinding = 0;
+        for (size_t i = 0, nFirst = 0; i < m_ends.size(); nFirst = m_ends[i++]) {
+            nWinding += internal::GetWinding(points, nFirst, m_ends[i], m_x, m_y);
+        }
+        if ( path.GetFillRule() == GDC_FILL_RULE_EVENODD ? (nWinding & 1) != 0 : nWinding != 0 ) {
+            m_bHit = true;
+            return;
+        }
+    }
+    const double dReach = pStrokePaint ? GetStrokeReach(*pStrokePaint) : m_dTolerance;
+    for (size_t i = 0, nFirst = 0; i < m_ends.size() && !m_bHit; nFirst = m_ends[i++]) {
+        // subpaths are closed by the fill
+        const bool bClosed = m_closed[i] || (pFillPaint && !pStrokePaint);
+        m_bHit = internal::GetPolyDistance2(points, nFirst, m_ends[i], bClosed, m_x, m_y) <= dReach * dReach;
+    }
+}
+
+void CHitTestGDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const double dReach = GetStrokeReach(paint);
+    const double rx = ::fabs(x2 - (double)x1) * 0.5;
+    const double ry = ::fabs(y2 - (double)y1) * 0.5;
+    const double xCenter = (x1 + (double)x2) * 0.5;
+    const double yCenter = (y1 + (double)y2) * 0.5;
+    m_bHit |= IsInEllipse(xCenter, yCenter, rx, ry, dReach) && !IsInEllipse(xCenter, yCenter, rx, ry, -dReach);
+}
+
+void CHitTestGDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const double rx = ::fabs(x2 - (double)x1) * 0.5;
+    const double ry = ::fabs(y2 - (double)y1) * 0.5;
+    m_bHit |= IsInEllipse((x1 + (double)x2) * 0.5, (y1 + (double)y2) * 0.5, rx, ry, GetStrokeReach(paint));
+}
+
+void CHitTestGDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint)
+{
+    // outer ellipse without the inner one (rx - h, ry - h)
+    m_bHit |= IsInEllipse(xCenter, yCenter, rx, ry, m_dTolerance) &&
+              !IsInEllipse(xCenter, yCenter, rx - h, ry - h, -m_dTolerance);
+}
+
+void CHitTestGDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint)
+{
+    // AngleArc with the lines from the center to the ends
+    GDCPathArc arc;
+    arc.m_center.x    = x;
+    arc.m_center.y    = y;
+    arc.m_nRadius     = nRadius;
+    arc.m_fStartAngle = fStartAngle;
+    arc.m_fSweepAngle = fSweepAngle;
+    const GDCPoint start = arc.GetStart();
+    const GDCPoint end   = arc.GetEnd();
+
+    const double dReach  = GetStrokeReach(paint);
+    const double dReach2 = dReach * dReach;
+    if ( internal::GetSegmentDistance2(m_x, m_y, x, y, start.x, start.y) <= dReach2 ||
+         internal::GetSegmentDistance2(m_x, m_y, x, y, end.x, end.y) <= dReach2 ) {
+        m_bHit = true;
+        return;
+    }
+    const double dx = m_x - x;
+    const double dy = m_y - y;
+    if ( ::fabs(::sqrt(dx * dx + dy * dy) - ::abs(nRadius)) > dReach ) {
+        return;
+    }
+    // counter clockwise from the start, y axis goes down
+    m_bHit |= internal::IsAngleInSweep(::atan2(-dy, dx) * 180. / HIT_TEST_PI, fStartAngle, fSweepAngle);
+}
+
+void CHitTestGDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint)
+{
+    const GDCFontDescr *pFont = paint.GetFontDescr();
+    if ( !pFont || !sText ) {
+        return;
+    }
+    const GDCSize size = GetTextExtent(sText, ::wcslen(sText), paint);
+    // text box relatively to the reference point (GDI TA_LEFT | TA_TOP by default)
+    double dLeft = 0.;
+    if ( pFont->m_nTextAlign & GDC_TA_CENTER ) {
+        dLeft = -size.cx * 0.5;
+    }
+    else if ( pFont->m_nTextAlign & GDC_TA_RIGHT ) {
+        dLeft = -size.cx;
+    }
+    double dTop = 0.;
+    if ( pFont->m_nTextAlign & GDC_TA_BOTTOM ) {
+        dTop = -size.cy;
+    }
+    else if ( pFont->m_nTextAlign & GDC_TA_BASELINE ) {
+        dTop = -size.cy * 0.8; // ascent
+    }
+    // point in the text direction axes (escapement: tenths of degree, counter clockwise)
+    const double dAngle = pFont->m_fAngle / 10. * HIT_TEST_PI / 180.;
+    const double dx = m_x - x;
+    const double dy = m_y - y;
+    const double u  = dx * ::cos(dAngle) - dy * ::sin(dAngle);
+    const double v  = dx * ::sin(dAngle) + dy * ::cos(dAngle);
+    m_bHit |= internal::IsRectHit(u, v, dLeft, dTop, dLeft + size.cx, dTop + size.cy, m_dTolerance);
+}
+
+void CHitTestGDC::DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
+{
+    m_bHit |= internal::IsRectHit(m_x, m_y, rect.left, rect.top, rect.right, rect.bottom, m_dTolerance);
+}
+
+void CHitTestGDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                    const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint)
+{
+    const GDCFontDescr *pFont = paint.GetFontDescr();
+    if ( !pFont || !sText ) {
+        return;
+    }
+    // band of the text height around the (rotated) ellipse
+    const double dReach = m_dTolerance + ::abs(pFont->m_nHeight);
+    const double dx = m_x - xCenter;
+    const double dy = m_y - yCenter;
+    const double u  = dx * ::cos(dEllipseAngleRad) + dy * ::sin(dEllipseAngleRad);
+    const double v  = -dx * ::sin(dEllipseAngleRad) + dy * ::cos(dEllipseAngleRad);
+    const double rx = ::abs(nRadiusX) + dReach;
+    const double ry = ::abs(nRadiusY) + dReach;
+    if ( (u / rx) * (u / rx) + (v / ry) * (v / ry) > 1. ) {
+        return;
+    }
+    const double rx_in = ::abs(nRadiusX) - dReach;
+    const double ry_in = ::abs(nRadiusY) - dReach;
+    if ( rx_in > 0. && ry_in > 0. && (u / rx_in) * (u / rx_in) + (v / ry_in) * (v / ry_in) < 1. ) {
+        return;
+    }
+    // text is centered at the dCenterAngle (ellipse parameter in degrees, as the GDI+ text path),
+    // its span is the text width divided by the arc length per radian at the center
+    const double dRadiusX = (std::max)((double)::abs(nRadiusX), 1.);
+    const double dRadiusY = (std::max)((double)::abs(nRadiusY), 1.);
+    const double dCenter  = dCenterAngle * HIT_TEST_PI / 180.;
+    const double dSpeedX  = dRadiusX * ::sin(dCenter);
+    const double dSpeedY  = dRadiusY * ::cos(dCenter);
+    const double dSpeed   = ::sqrt(dSpeedX * dSpeedX + dSpeedY * dSpeedY);
+    const double dHalfSweep = (GetTextExtent(sText, ::wcslen(sText), paint).cx * 0.5 + m_dTolerance) / (std::max)(dSpeed, 1.) * 180. / HIT_TEST_PI;
+    m_bHit |= internal::IsAngleInSweep(::atan2(v / dRadiusY, u / dRadiusX) * 180. / HIT_TEST_PI, dCenterAngle - dHalfSweep, 2. * dHalfSweep);
+}
+
+void CHitTestGDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                   bool bRevertTextDir, const GDCPaint &paint)
+{
+    const GDCFontDescr *pFont = paint.GetFontDescr();
+    if ( !pFont || !sText ) {
+        return;
+    }
+    const double dReach = m_dTolerance + ::abs(pFont->m_nHeight);
+    const double dx = m_x - nCX;
+    const double dy = m_y - nCY;
+    if ( ::fabs(::sqrt(dx * dx + dy * dy) - ::abs(nRadius)) > dReach ) {
+        return;
+    }
+    // text is centered at the dCenterAngle (degrees, clockwise as the GDI+ text path), the direction does not change the span
+    const double dRadius    = (std::max)((double)::abs(nRadius), 1.);
+    const double dHalfSweep = (GetTextExtent(sText, ::wcslen(sText), paint).cx * 0.5 + m_dTolerance) / dRadius * 180. / HIT_TEST_PI;
+    m_bHit |= internal::IsAngleInSweep(::atan2(dy, dx) * 180. / HIT_TEST_PI, dCenterAngle - dHalfSweep, 2. * dHalfSweep);
+}
+
+int32_t CHitTestGDC::GetTextHeight(const GDCPaint &paint) const
+{
+    return m_measure.GetTextHeight(paint);
+}
+
+GDCSize CHitTestGDC::GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const
+{
+    return m_measure.GetTextExtent(sText, nCount, paint);
+}
@@ -0,0 +1,115 @@
+#ifndef __HIT_TEST_GDC_H__
+#define __HIT_TEST_GDC_H__
+#pragma once
+
+#ifndef __ABS_GDC_H__
+    #include "../AbsGDC.h"
+#endif
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+#ifndef __SCREEN_MEASURE_H__
+    #include "ScreenMeasure.h"
+#endif
+
+#include "vector"
+
+// Backend which tests the geometry of the calls against the point instead of drawing:
+// fills (polygons, rectangles, ellipses, paths), strokes (distance to the lines) and text boxes.
+class CHitTestGDC final : public CAbsGDC
+{
+// Construction/Destruction
+public:
+    CHitTestGDC(int32_t x, int32_t y, int32_t nTolerance);
+    virtual ~CHitTestGDC() { }
+
+private:
+    CHitTestGDC(const CHitTestGDC &gdc);
+
+// Operations
+public:
+    bool IsHit() const { return m_bHit; }
+    void Reset()       { m_bHit = false; }
+
+// Overrides
+public:
+    virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override;
+
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                    const wchar_t *sTexturePath, double dAngle, float fZoom) override;
+
+    virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override;
+    virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override;
+
+    virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint) override;
+    virtual void DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint) override;
+
+    // size of the bitmap is not recorded -> never hit
+    virtual void DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y) override { }
+
+    virtual void TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint) override;
+    virtual void DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint) override;
+    virtual void DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                   const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint) override;
+    virtual void DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                  bool bRevertTextDir, const GDCPaint &paint) override;
+
+    // measured with the screen dc (as svg), dc is created once for the whole hit test
+    virtual int32_t GetTextHeight(const GDCPaint &paint) const override;
+    virtual GDCSize GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const override;
+
+    // point is moved into the coordinates of the following calls
+    virtual void SetViewportOrg(int32_t x, int32_t y) override;
+    virtual GDCPoint GetViewportOrg() const override           { return m_org; }
+
+    virtual void SetCurveTolerance(float fTolerance) override  { }
+
+    virtual void BeginGroup(const char *sGroupAttributes) override { }
+    virtual void EndGroup() override { }
+
+    virtual HDC GetHDC() override { return nullptr; }
+
+private:
+    double GetStrokeReach(const GDCPaint &paint) const;
+    // point is inside of the ellipse extended by the dExtent
+    bool IsInEllipse(double xCenter, double yCenter, double rx, double ry, double dExtent) const;
+    void FlattenPath(const GDCPath &path);
+
+// Attributes
+private:
+    int32_t m_xTest;
+    int32_t m_yTest;
+    GDCPoint m_org;
+    double m_x; // m_xTest - m_org.x
+    double m_y;
+    double m_dTolerance;
+    bool m_bHit {false};
+    mutable CScreenMeasure m_measure; // text candidates
+
+    // flattened path: subpaths end at the m_ends (closed flag in the m_closed)
+    std::vector<GDCPoint> m_points;
+    std::vector<size_t> m_ends;
+    std::vector<uint8_t> m_closed;
+};
+
+#endif
@@ -0,0 +1,256 @@
+#include "stdafx.h"
+#include "ListDiff.h"
+
+#include "ListIndex.h"
+#include "HashGDC.h"
+
+#include "algorithm"
+#include "math.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define LIST_DIFF_HASH_BASIS   0xCBF29CE484222325ULL
+#define LIST_DIFF_MAX_PAIRWISE 1024 // more rectangles are joined by the grid cells first
+#define LIST_DIFF_MERGE_FACTOR 32   // pairwise merge of nMaxRects * factor rectangles at most
+
+namespace internal
+{
+    static inline bool AreRectsTouching(const RECT &a, const RECT &b) {
+        return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+    }
+
+    static inline void JoinRect(RECT &rect, const RECT &other) {
+        rect.left   = (std::min)(rect.left,   other.left);
+        rect.top    = (std::min)(rect.top,    other.top);
+        rect.right  = (std::max)(rect.right,  other.right);
+        rect.bottom = (std::max)(rect.bottom, other.bottom);
+    }
+
+    static inline double GetRectArea(const RECT &rect) {
+        return ((double)rect.right - rect.left) * ((double)rect.bottom - rect.top);
+    }
+
+    // rectangles are joined by the cells (of their center) of the uniform grid over the extent -> nMaxCells rectangles at most
+    static void JoinCells(std::vector<RECT> &rects, size_t nMaxCells)
+    {
+        if ( rects.empty() ) {
+            return;
+        }
+        const size_t nSide = (std::max)((size_t)::sqrt((double)nMaxCells), (size_t)1);
+        RECT extent = rects[0];
+        for (const RECT &rect : rects) {
+            JoinRect(extent, rect);
+        }
+        const double dCellX = ((double)extent.right - extent.left + 1.) / nSide;
+        const double dCellY = ((double)extent.bottom - extent.top + 1.) / nSide;
+        std::vector<RECT> cells(nSide * nSide);
+        std::vector<uint8_t> used(nSide * nSide, 0);
+        for (const RECT &rect : rects) {
+            const size_t ix = (std::min)((size_t)((((double)rect.left + rect.right) * 0.5 - extent.left) / dCellX), nSide - 1);
+            const size_t iy = (std::min)((size_t)((((double)rect.top + rect.bottom) * 0.5 - extent.top) / dCellY), nSide - 1);
+            const size_t iCell = iy * nSide + ix;
+            if ( used[iCell] ) {
+                JoinRect(cells[iCell], rect);
+            }
+            else {
+                cells[iCell] = rect;
+                used[iCell]  = 1;
+            }
+        }
+        rects.clear();
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if ( used[i] ) {
+                rects.push_back(cells[i]);
+            }
+        }
+    }
+
+    // merge candidate of the rectangle m_i: touching rectangles go first (bTouchFirst), then the smallest area growth
+    class CRectPair final
+    {
+    // Construction/Destruction
+    public:
+        CRectPair() { }
+        CRectPair(const std::vector<RECT> &rects, uint32_t i, uint32_t j, bool bTouchFirst) : m_i(i), m_j(j) {
+            RECT joined = rects[i];
+            JoinRect(joined, rects[j]);
+            m_dGrowth   = GetRectArea(joined) - GetRectArea(rects[i]) - GetRectArea(rects[j]);
+            m_bTouching = bTouchFirst && AreRectsTouching(rects[i], rects[j]);
+        }
+
+    // Operations
+    public:
+        bool IsBetter(const CRectPair &pair) const {
+            if ( m_bTouching != pair.m_bTouching ) {
+                return m_bTouching;
+            }
+            return m_dGrowth < pair.m_dGrowth;
+        }
+
+    // Attributes
+    public:
+        double m_dGrowth {HUGE_VAL};
+        uint32_t m_i {0};
+        uint32_t m_j {UINT32_MAX};
+        bool m_bTouching {false};
+    };
+};
+
+void CListDiff::MatchGroups(const CListDigest &old_digest, const CListDigest &new_digest)
+{
+    // signatures are sorted -> equal groups are matched by the merge
+    m_old_covered.assign(old_digest.m_parents.size(), 0);
+    m_new_covered.assign(new_digest.m_parents.size(), 0);
+    auto itOld = old_digest.m_signatures.begin();
+    auto itNew = new_digest.m_signatures.begin();
+    while ( itOld != old_digest.m_signatures.end() && itNew != new_digest.m_signatures.end() ) {
+        if ( itOld->first < itNew->first ) {
+            ++itOld;
+        }
+        else if ( itNew->first < itOld->first ) {
+            ++itNew;
+        }
+        else {
+            m_old_covered[(itOld++)->second] = 1;
+            m_new_covered[(itNew++)->second] = 1;
+        }
+    }
+    // parents go before the children
+    for (size_t i = 0; i < m_old_covered.size(); ++i) {
+        const size_t iParent = old_digest.m_parents[i];
+        if ( iParent != SIZE_MAX && m_old_covered[iParent] ) {
+            m_old_covered[i] = 1;
+        }
+    }
+    for (size_t i = 0; i < m_new_covered.size(); ++i) {
+        const size_t iParent = new_digest.m_parents[i];
+        if ( iParent != SIZE_MAX && m_new_covered[iParent] ) {
+            m_new_covered[i] = 1;
+        }
+    }
+}
+
+void CListDiff::AddCommands(const CListIndexView &index, const CListDigest &digest, const std::vector<uint8_t> &covered, bool bNew)
+{
+    for (size_t i = 0; i < digest.m_order.size(); ++i) {
+        const size_t iGroup = digest.m_item_groups[i];
+        if ( iGroup != SIZE_MAX && covered[iGroup] ) {
+            continue;
+        }
+        const uint32_t iItem = digest.m_order[i];
+        const uint64_t nKey  = CHashGDC::Combine(iGroup != SIZE_MAX ? digest.m_attributes[iGroup] : LIST_DIFF_HASH_BASIS,
+                                                 digest.m_hashes[i]);
+        CCommand &command = m_commands[nKey];
+        command.m_nBalance += bNew ? -1 : 1;
+        // equal hash -> equal bounds
+        const CListItem &item   = index.m_pItems[iItem];
+        command.m_bounds.left   = item.m_nMinX;
+        command.m_bounds.top    = item.m_nMinY;
+        command.m_bounds.right  = item.m_nMaxX;
+        command.m_bounds.bottom = item.m_nMaxY;
+    }
+}
+
+void CListDiff::MergeRects(std::vector<RECT> &rects, size_t nMaxRects)
+{
+    nMaxRects = (std::max)(nMaxRects, (size_t)1);
+    const size_t nPairwise = (std::min)((size_t)LIST_DIFF_MAX_PAIRWISE, nMaxRects * LIST_DIFF_MERGE_FACTOR);
+    bool bTouchFirst = true;
+    if ( rects.size() > nPairwise ) {
+        if ( rects.size() <= nMaxRects ) {
+            return; // count is allowed, touching ones are not joined
+        }
+        internal::JoinCells(rects, nPairwise);
+        bTouchFirst = false; // neighbour cells touch -> area growth only
+    }
+
+    // touching rectangles are joined, then the pairs with the smallest area growth.
+    // Best pair of every rectangle is kept -> merge costs O(n) unless the partner of many ones is merged.
+    const uint32_t nRects = (uint32_t)rects.size();
+    std::vector<uint8_t> alive(nRects, 1);
+    std::vector<internal::CRectPair> best(nRects);
+    auto FindBest = [&](uint32_t i) {
+        best[i] = internal::CRectPair();
+        for (uint32_t j = 0; j < nRects; ++j) {
+            if ( j != i && alive[j] ) {
+                const internal::CRectPair pair(rects, i, j, bTouchFirst);
+                if ( pair.IsBetter(best[i]) ) {
+                    best[i] = pair;
+                }
+            }
+        }
+    };
+    for (uint32_t i = 0; i < nRects; ++i) {
+        FindBest(i);
+    }
+    size_t nAlive = nRects;
+    while ( nAlive > 1 ) {
+        uint32_t iBest = UINT32_MAX;
+        for (uint32_t i = 0; i < nRects; ++i) {
+            if ( alive[i] && (iBest == UINT32_MAX || best[i].IsBetter(best[iBest])) ) {
+                iBest = i;
+            }
+        }
+        const internal::CRectPair pair = best[iBest];
+        if ( !pair.m_bTouching ) {
+            if ( nAlive <= nMaxRects ) {
+                break;
+            }
+            if ( bTouchFirst ) { // touching ones are joined -> area growth only
+                bTouchFirst = false;
+                for (uint32_t i = 0; i < nRects; ++i) {
+                    if ( alive[i] ) {
+                        FindBest(i);
+                    }
+                }
+                continue;
+            }
+        }
+        // joined rectangle takes the place of the m_i
+        internal::JoinRect(rects[pair.m_i], rects[pair.m_j]);
+        alive[pair.m_j] = 0;
+        --nAlive;
+        for (uint32_t i = 0; i < nRects; ++i) {
+            if ( !alive[i] ) {
+                continue;
+            }
+            if ( i == pair.m_i || best[i].m_j == pair.m_i || best[i].m_j == pair.m_j ) {
+                FindBest(i);
+            }
+            else {
+                const internal::CRectPair joined(rects, i, pair.m_i, bTouchFirst);
+                if ( joined.IsBetter(best[i]) ) {
+                    best[i] = joined;
+                }
+            }
+        }
+    }
+
+    size_t nCount = 0;
+    for (size_t i = 0; i < rects.size(); ++i) {
+        if ( alive[i] ) {
+            rects[nCount++] = rects[i];
+        }
+    }
+    rects.resize(nCount);
+}
+
+void CListDiff::Diff(const CListIndexView &old_index, const CListDigest &old_digest,
+                     const CListIndexView &new_index, const CListDigest &new_digest,
+                     size_t nMaxRects, std::vector<RECT> &dirty)
+{
+    dirty.clear();
+    MatchGroups(old_digest, new_digest);
+
+    m_commands.clear();
+    AddCommands(old_index, old_digest, m_old_covered, false);
+    AddCommands(new_index, new_digest, m_new_covered, true);
+    for (const auto &command : m_commands) {
+        if ( command.second.m_nBalance != 0 ) {
+            dirty.push_back(command.second.m_bounds);
+        }
+    }
+    MergeRects(dirty, nMaxRects);
+}
@@ -0,0 +1,55 @@
+#ifndef __LIST_DIFF_H__
+#define __LIST_DIFF_H__
+#pragma once
+
+#ifndef __LIST_DIGEST_H__
+    #include "ListDigest.h"
+#endif
+
+#include "vector"
+#include "unordered_map"
+
+class CListIndexView;
+
+// Difference of two recordings of the scene as the dirty rectangles (spatial index bounds of the commands).
+// Groups are matched by the attributes and the content (signature) -> equal groups are skipped as a whole,
+// commands of the other groups are matched by the content hash within the same group attributes.
+class CListDiff final
+{
+// Construction/Destruction
+public:
+    CListDiff() { }
+    ~CListDiff() { }
+
+private:
+    CListDiff(const CListDiff &diff);
+
+// Operations
+public:
+    // digests: CListPlayer::GetDigest
+    void Diff(const CListIndexView &old_index, const CListDigest &old_digest,
+              const CListIndexView &new_index, const CListDigest &new_digest,
+              size_t nMaxRects, std::vector<RECT> &dirty);
+
+private:
+    void MatchGroups(const CListDigest &old_digest, const CListDigest &new_digest);
+    // bNew: commands are subtracted
+    void AddCommands(const CListIndexView &index, const CListDigest &digest, const std::vector<uint8_t> &covered, bool bNew);
+    static void MergeRects(std::vector<RECT> &rects, size_t nMaxRects);
+
+    class CCommand final
+    {
+    // Attributes
+    public:
+        int32_t m_nBalance {0}; // old commands - new commands
+        RECT m_bounds;
+    };
+
+// Attributes
+private:
+    std::vector<uint8_t> m_old_covered; // group or its parent is matched
+    std::vector<uint8_t> m_new_covered;
+    std::unordered_map<uint64_t, CCommand> m_commands;
+};
+
+#endif
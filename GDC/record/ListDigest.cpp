@@ -0,0 +1,75 @@
+#include "stdafx.h"
+#include "ListDigest.h"
+
+#include "ListPlayer.h"
+#include "HashGDC.h"
+
+#include "algorithm"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define LIST_DIGEST_HASH_BASIS 0xCBF29CE484222325ULL
+
+bool CListDigest::IsValid(const CListSections &sections) const
+{
+    return m_order.size() == sections.m_index.m_nItems && m_parents.size() == sections.m_nGroups &&
+           m_hashes.size() == m_order.size();
+}
+
+void CListDigest::BuildGroups(const CListSections &sections)
+{
+    const CListIndexView &index = sections.m_index;
+    const size_t nGroups = sections.m_nGroups;
+    ASSERT(m_order.size() == index.m_nItems && m_hashes.size() == m_order.size());
+
+    m_item_groups.resize(m_order.size());
+    m_parents.assign(nGroups, SIZE_MAX);
+    m_attributes.assign(nGroups, LIST_DIGEST_HASH_BASIS);
+    std::vector<uint64_t> contents(nGroups, LIST_DIGEST_HASH_BASIS); // nested groups and commands
+
+    // groups are in the begin order, the stack keeps the open ones
+    std::vector<size_t> stack;
+    size_t iGroup = 0;
+    auto PopClosed = [&](uint64_t nOffset) {
+        while ( !stack.empty() ) {
+            const GDCListGroup &group = sections.m_pGroups[stack.back()];
+            if ( group.m_nEnd == 0 || nOffset < group.m_nEnd ) {
+                break;
+            }
+            stack.pop_back();
+        }
+    };
+    auto EnterGroups = [&](uint64_t nOffset) {
+        for (; iGroup < nGroups && sections.m_pGroups[iGroup].m_nBegin < nOffset; ++iGroup) {
+            PopClosed(sections.m_pGroups[iGroup].m_nBegin);
+            const size_t iParent = stack.empty() ? SIZE_MAX : stack.back();
+            const std::string sAttributes = CListPlayer::GetGroupAttributes(sections, iGroup);
+            m_parents[iGroup]    = iParent;
+            m_attributes[iGroup] = CHashGDC::Combine(iParent == SIZE_MAX ? LIST_DIGEST_HASH_BASIS : m_attributes[iParent],
+                                                     CHashGDC::HashBytes(sAttributes.data(), sAttributes.size()));
+            for (const size_t iOpen : stack) {
+                contents[iOpen] = CHashGDC::Combine(contents[iOpen], m_attributes[iGroup]);
+            }
+            stack.push_back(iGroup);
+        }
+    };
+    for (size_t i = 0; i < m_order.size(); ++i) {
+        const uint64_t nOffset = index.m_pItems[m_order[i]].m_nOffset;
+        EnterGroups(nOffset);
+        PopClosed(nOffset);
+        for (const size_t iOpen : stack) {
+            contents[iOpen] = CHashGDC::Combine(contents[iOpen], m_hashes[i]);
+        }
+        m_item_groups[i] = stack.empty() ? SIZE_MAX : stack.back();
+    }
+    EnterGroups(UINT64_MAX); // empty groups at the end
+
+    m_signatures.resize(nGroups);
+    for (size_t i = 0; i < nGroups; ++i) {
+        m_signatures[i].first  = CHashGDC::Combine(m_attributes[i], contents[i]);
+        m_signatures[i].second = (uint32_t)i;
+    }
+    std::sort(m_signatures.begin(), m_signatures.end());
+}
@@ -0,0 +1,37 @@
+#ifndef __LIST_DIGEST_H__
+#define __LIST_DIGEST_H__
+#pragma once
+
+#include "vector"
+#include "utility"
+#include "stdint.h"
+
+class CListSections;
+
+// Content of the recording for the CListDiff: command hashes (CHashGDC) in the draw order and the group signatures.
+// Kept in the CListResources -> the previous recording is not hashed again.
+class CListDigest final
+{
+// Construction/Destruction
+public:
+    CListDigest() { }
+    ~CListDigest() { }
+
+// Operations
+public:
+    // index is rebuilt by the next recorder only with the new items
+    bool IsValid(const CListSections &sections) const;
+    // m_order and m_hashes are set
+    void BuildGroups(const CListSections &sections);
+
+// Attributes
+public:
+    std::vector<uint32_t> m_order;      // index items in the draw order
+    std::vector<uint64_t> m_hashes;     // of the m_order items
+    std::vector<size_t> m_item_groups;  // innermost group of the m_order item, SIZE_MAX: none
+    std::vector<size_t> m_parents;      // SIZE_MAX: top level group
+    std::vector<uint64_t> m_attributes; // hash of the attributes with the parent ones
+    std::vector<std::pair<uint64_t, uint32_t>> m_signatures; // attributes and content of the group, sorted
+};
+
+#endif
@@ -0,0 +1,174 @@
+#include "stdafx.h"
+#include "ListFile.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+static_assert(sizeof(CListFileHeader) == 128, "display list file header layout");
+static_assert(sizeof(GDCListGroup) == 32, "display list file group layout");
+static_assert(sizeof(CListItem) == 32, "display list file item layout");
+static_assert(sizeof(CListNode) == 24, "display list file node layout");
+
+static const char s_sListMagic[8] = "GDCLIST";
+
+namespace internal
+{
+    static inline uint64_t AlignListOffset(uint64_t nOffset) {
+        return (nOffset + GDC_LIST_FILE_ALIGN - 1) & ~(uint64_t)(GDC_LIST_FILE_ALIGN - 1);
+    }
+
+    static bool WriteListSection(FILE *pFile, uint64_t &nPos, uint64_t nOffset, const void *pData, size_t nSize)
+    {
+        static const uint8_t zeros[GDC_LIST_FILE_ALIGN] = { };
+        ASSERT(nOffset >= nPos && nOffset - nPos <= GDC_LIST_FILE_ALIGN);
+        const size_t nPadding = (size_t)(nOffset - nPos);
+        if ( nPadding && ::fwrite(zeros, 1, nPadding, pFile) != nPadding ) {
+            return false;
+        }
+        if ( nSize && ::fwrite(pData, 1, nSize, pFile) != nSize ) {
+            return false;
+        }
+        nPos = nOffset + nSize;
+        return true;
+    }
+
+    static inline bool IsListSectionValid(uint64_t nOffset, uint64_t nSize, uint64_t nFileSize) {
+        return nOffset <= nFileSize && nSize <= nFileSize - nOffset;
+    }
+
+    template <class T>
+    static inline bool IsListArrayValid(uint64_t nOffset, uint64_t nCount, uint64_t nFileSize) {
+        return nCount <= nFileSize / sizeof(T) && IsListSectionValid(nOffset, nCount * sizeof(T), nFileSize) && nOffset % alignof(T) == 0;
+    }
+};
+
+CListFile::~CListFile()
+{
+    Close();
+}
+
+bool CListFile::Write(const wchar_t *sFilePath, const CListSections &sections, uint64_t nCommandCount)
+{
+    CListFileHeader header;
+    ::memset(&header, 0, sizeof(header));
+    ::memcpy(header.m_sMagic, s_sListMagic, sizeof(header.m_sMagic));
+    header.m_nVersion        = GDC_LIST_FILE_VERSION;
+    header.m_nHeaderSize     = sizeof(CListFileHeader);
+    header.m_nDefsOffset     = GDC_LIST_FILE_ALIGN;
+    header.m_nDefsSize       = sections.m_nDefsSize;
+    header.m_nCommandsOffset = internal::AlignListOffset(header.m_nDefsOffset + header.m_nDefsSize);
+    header.m_nCommandsSize   = sections.m_nCommandsSize;
+    header.m_nGroupsOffset   = internal::AlignListOffset(header.m_nCommandsOffset + header.m_nCommandsSize);
+    header.m_nGroupCount     = sections.m_nGroups;
+    header.m_nCommandCount   = nCommandCount;
+    const CListIndexView &index = sections.m_index;
+    header.m_nItemsOffset    = internal::AlignListOffset(header.m_nGroupsOffset + header.m_nGroupCount * sizeof(GDCListGroup));
+    header.m_nItemCount      = index.m_nItems;
+    header.m_nNodesOffset    = internal::AlignListOffset(header.m_nItemsOffset + header.m_nItemCount * sizeof(CListItem));
+    header.m_nNodeCount      = index.m_nNodes;
+    header.m_nLeafNodeCount  = index.m_nLeafNodes;
+
+    FILE *pFile = ::_wfopen(sFilePath, L"wb");
+    ASSERT(pFile);
+    if ( !pFile ) {
+        return false;
+    }
+    uint64_t nPos = 0;
+    bool bResult = internal::WriteListSection(pFile, nPos, 0, &header, sizeof(header)) &&
+                   internal::WriteListSection(pFile, nPos, header.m_nDefsOffset, sections.m_pDefs, sections.m_nDefsSize) &&
+                   internal::WriteListSection(pFile, nPos, header.m_nCommandsOffset, sections.m_pCommands, sections.m_nCommandsSize) &&
+                   internal::WriteListSection(pFile, nPos, header.m_nGroupsOffset, sections.m_pGroups, sections.m_nGroups * sizeof(GDCListGroup)) &&
+                   internal::WriteListSection(pFile, nPos, header.m_nItemsOffset, index.m_pItems, index.m_nItems * sizeof(CListItem)) &&
+                   internal::WriteListSection(pFile, nPos, header.m_nNodesOffset, index.m_pNodes, index.m_nNodes * sizeof(CListNode));
+    if ( ::fclose(pFile) != 0 ) {
+        bResult = false;
+    }
+    ASSERT(bResult);
+    return bResult;
+}
+
+bool CListFile::Open(const wchar_t *sFilePath)
+{
+    Close();
+
+    m_hFile = ::CreateFileW(sFilePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if ( m_hFile == INVALID_HANDLE_VALUE ) {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if ( !::GetFileSizeEx(m_hFile, &file_size) || (uint64_t)file_size.QuadPart < sizeof(CListFileHeader) ||
+         (uint64_t)file_size.QuadPart > (uint64_t)SIZE_MAX ) {
+        Close();
+        return false;
+    }
+    const uint64_t nFileSize = (uint64_t)file_size.QuadPart;
+
+    m_hMapping = ::CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if ( !m_hMapping ) {
+        Close();
+        return false;
+    }
+    m_pView = (const uint8_t *)::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    if ( !m_pView ) {
+        Close();
+        return false;
+    }
+
+    const CListFileHeader *pHeader = (const CListFileHeader *)m_pView;
+    if ( ::memcmp(pHeader->m_sMagic, s_sListMagic, sizeof(pHeader->m_sMagic)) != 0 ||
+         pHeader->m_nVersion == 0 || pHeader->m_nVersion > GDC_LIST_FILE_VERSION ||
+         pHeader->m_nHeaderSize < sizeof(CListFileHeader) ) {
+        Close();
+        return false;
+    }
+    const bool bValid = internal::IsListSectionValid(pHeader->m_nDefsOffset, pHeader->m_nDefsSize, nFileSize) &&
+                        internal::IsListSectionValid(pHeader->m_nCommandsOffset, pHeader->m_nCommandsSize, nFileSize) &&
+                        internal::IsListArrayValid<GDCListGroup>(pHeader->m_nGroupsOffset, pHeader->m_nGroupCount, nFileSize) &&
+                        internal::IsListArrayValid<CListItem>(pHeader->m_nItemsOffset, pHeader->m_nItemCount, nFileSize) &&
+                        internal::IsListArrayValid<CListNode>(pHeader->m_nNodesOffset, pHeader->m_nNodeCount, nFileSize) &&
+                        pHeader->m_nLeafNodeCount <= pHeader->m_nNodeCount;
+    if ( !bValid ) {
+        ASSERT(FALSE); // truncated file
+        Close();
+        return false;
+    }
+
+    m_sections.m_pDefs         = m_pView + pHeader->m_nDefsOffset;
+    m_sections.m_nDefsSize     = (size_t)pHeader->m_nDefsSize;
+    m_sections.m_pCommands     = m_pView + pHeader->m_nCommandsOffset;
+    m_sections.m_nCommandsSize = (size_t)pHeader->m_nCommandsSize;
+    m_sections.m_pGroups       = (const GDCListGroup *)(m_pView + pHeader->m_nGroupsOffset);
+    m_sections.m_nGroups       = (size_t)pHeader->m_nGroupCount;
+    m_nCommandCount            = (size_t)pHeader->m_nCommandCount;
+    CListIndexView &index = m_sections.m_index;
+    index.m_pItems     = (const CListItem *)(m_pView + pHeader->m_nItemsOffset);
+    index.m_nItems     = (size_t)pHeader->m_nItemCount;
+    index.m_pNodes     = (const CListNode *)(m_pView + pHeader->m_nNodesOffset);
+    index.m_nNodes     = (size_t)pHeader->m_nNodeCount;
+    index.m_nLeafNodes = (size_t)pHeader->m_nLeafNodeCount;
+    return true;
+}
+
+void CListFile::Close()
+{
+    if ( m_pView ) {
+        ::UnmapViewOfFile(m_pView);
+        m_pView = nullptr;
+    }
+    if ( m_hMapping ) {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+    if ( m_hFile != INVALID_HANDLE_VALUE ) {
+        ::CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+    m_sections      = CListSections();
+    m_nCommandCount = 0;
+}
+
+std::string CListFile::GetGroupAttributes(size_t iGroup) const
+{
+    return CListPlayer::GetGroupAttributes(m_sections, iGroup);
+}
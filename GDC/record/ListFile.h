@@ -0,0 +1,78 @@
+#ifndef __LIST_FILE_H__
+#define __LIST_FILE_H__
+#pragma once
+
+#ifndef __LIST_PLAYER_H__
+    #include "ListPlayer.h"
+#endif
+
+#ifndef __LIST_RESOURCES_H__
+    #include "ListResources.h"
+#endif
+
+#define GDC_LIST_FILE_VERSION 1
+#define GDC_LIST_FILE_ALIGN   4096 // sections start at the page boundary
+
+// Display list file (little endian): header, definitions, commands, the group index (GDCListGroup array)
+// and the R-tree (CListItem, CListNode arrays). Every section is used straight from the mapped view.
+class CListFileHeader final
+{
+// Attributes
+public:
+    char m_sMagic[8];           // "GDCLIST"
+    uint32_t m_nVersion;        // GDC_LIST_FILE_VERSION
+    uint32_t m_nHeaderSize;     // sizeof(CListFileHeader) (newer versions may extend it)
+    uint64_t m_nDefsOffset;
+    uint64_t m_nDefsSize;
+    uint64_t m_nCommandsOffset;
+    uint64_t m_nCommandsSize;
+    uint64_t m_nGroupsOffset;
+    uint64_t m_nGroupCount;
+    uint64_t m_nCommandCount;
+    uint64_t m_nItemsOffset;
+    uint64_t m_nItemCount;
+    uint64_t m_nNodesOffset;
+    uint64_t m_nNodeCount;
+    uint64_t m_nLeafNodeCount;
+    uint8_t m_reserved[16];
+};
+
+// Read only mapping of the display list file
+class CListFile final
+{
+// Construction/Destruction
+public:
+    CListFile() { }
+    ~CListFile();
+
+private:
+    CListFile(const CListFile &file);
+
+// Static operations
+public:
+    static bool Write(const wchar_t *sFilePath, const CListSections &sections, uint64_t nCommandCount);
+
+// Operations
+public:
+    // header and section bounds are validated, the sections are not read
+    bool Open(const wchar_t *sFilePath);
+
+    const CListSections &GetSections() const { return m_sections; }
+    CListResources &GetResources() const     { return m_resources; }
+    size_t GetCommandCount() const           { return m_nCommandCount; }
+    std::string GetGroupAttributes(size_t iGroup) const;
+
+private:
+    void Close();
+
+// Attributes
+private:
+    HANDLE m_hFile {INVALID_HANDLE_VALUE};
+    HANDLE m_hMapping {nullptr};
+    const uint8_t *m_pView {nullptr};
+    CListSections m_sections;
+    size_t m_nCommandCount {0};
+    mutable CListResources m_resources; // decoded on the first replay
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "stdafx.h"
+#include "ListIndex.h"
+
+#include "algorithm"
+#include "cmath"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define GDC_LIST_NODE_SIZE 16 // children of the node
+
+void CListItem::Pad(int32_t nPad)
+{
+    m_nMinX = (int32_t)(std::max)((int64_t)m_nMinX - nPad, (int64_t)INT32_MIN);
+    m_nMinY = (int32_t)(std::max)((int64_t)m_nMinY - nPad, (int64_t)INT32_MIN);
+    m_nMaxX = (int32_t)(std::min)((int64_t)m_nMaxX + nPad, (int64_t)INT32_MAX);
+    m_nMaxY = (int32_t)(std::min)((int64_t)m_nMaxY + nPad, (int64_t)INT32_MAX);
+}
+
+void CListItem::Offset(int32_t dx, int32_t dy)
+{
+    m_nMinX = (int32_t)(std::max)((int64_t)m_nMinX + dx, (int64_t)INT32_MIN);
+    m_nMinY = (int32_t)(std::max)((int64_t)m_nMinY + dy, (int64_t)INT32_MIN);
+    m_nMaxX = (int32_t)(std::min)((int64_t)m_nMaxX + dx, (int64_t)INT32_MAX);
+    m_nMaxY = (int32_t)(std::min)((int64_t)m_nMaxY + dy, (int64_t)INT32_MAX);
+}
+
+namespace internal
+{
+    template <class T> static inline int64_t GetCenterX(const T &box) { return (int64_t)box.m_nMinX + box.m_nMaxX; }
+    template <class T> static inline int64_t GetCenterY(const T &box) { return (int64_t)box.m_nMinY + box.m_nMaxY; }
+
+    // Sort-Tile-Recursive: vertical slices by the x center, nodes of the slice by the y center
+    template <class T>
+    static void SortTiles(T *pFirst, size_t nCount)
+    {
+        const size_t nNodes  = (nCount + GDC_LIST_NODE_SIZE - 1) / GDC_LIST_NODE_SIZE;
+        const size_t nSlices = (size_t)std::ceil(std::sqrt((double)nNodes));
+        const size_t nSlice  = nSlices * GDC_LIST_NODE_SIZE;
+        std::sort(pFirst, pFirst + nCount, [](const T &a, const T &b) { return GetCenterX(a) < GetCenterX(b); });
+        for (size_t i = 0; i < nCount; i += nSlice) {
+            const size_t nEnd = (std::min)(i + nSlice, nCount);
+            std::sort(pFirst + i, pFirst + nEnd, [](const T &a, const T &b) { return GetCenterY(a) < GetCenterY(b); });
+        }
+    }
+
+    // parents of the [pFirst, pFirst + nCount) are appended to the nodes (first child index is nBase)
+    template <class T>
+    static void AddParents(const T *pFirst, size_t nCount, size_t nBase, std::vector<CListNode> &nodes)
+    {
+        for (size_t i = 0; i < nCount; i += GDC_LIST_NODE_SIZE) {
+            const size_t nEnd = (std::min)(i + GDC_LIST_NODE_SIZE, nCount);
+            CListNode node;
+            node.m_nMinX  = INT32_MAX;
+            node.m_nMinY  = INT32_MAX;
+            node.m_nMaxX  = INT32_MIN;
+            node.m_nMaxY  = INT32_MIN;
+            node.m_nFirst = (uint32_t)(nBase + i);
+            node.m_nCount = (uint32_t)(nEnd - i);
+            for (size_t j = i; j < nEnd; ++j) {
+                node.m_nMinX = (std::min)(node.m_nMinX, pFirst[j].m_nMinX);
+                node.m_nMinY = (std::min)(node.m_nMinY, pFirst[j].m_nMinY);
+                node.m_nMaxX = (std::max)(node.m_nMaxX, pFirst[j].m_nMaxX);
+                node.m_nMaxY = (std::max)(node.m_nMaxY, pFirst[j].m_nMaxY);
+            }
+            nodes.push_back(node);
+        }
+    }
+
+    template <class T>
+    static inline bool Intersects(const T &box, const RECT &rect) {
+        return box.m_nMinX <= rect.right && rect.left <= box.m_nMaxX &&
+               box.m_nMinY <= rect.bottom && rect.top <= box.m_nMaxY;
+    }
+};
+
+void CListIndex::Build()
+{
+    if ( m_bBuilt ) {
+        return;
+    }
+    m_bBuilt = true;
+    m_nodes.clear();
+    m_nLeafNodes = 0;
+    if ( m_items.empty() ) {
+        return;
+    }
+    ASSERT(m_items.size() <= UINT32_MAX);
+
+    // parents are read from the m_nodes while appended -> no reallocation
+    size_t nNodes = 0;
+    for (size_t nCount = m_items.size(); nCount > 1 || nNodes == 0; ) {
+        nCount  = (nCount + GDC_LIST_NODE_SIZE - 1) / GDC_LIST_NODE_SIZE;
+        nNodes += nCount;
+    }
+    m_nodes.reserve(nNodes);
+
+    internal::SortTiles(m_items.data(), m_items.size());
+    internal::AddParents(m_items.data(), m_items.size(), 0, m_nodes);
+    m_nLeafNodes = m_nodes.size();
+
+    size_t nLevel = 0; // first node of the level
+    while ( m_nodes.size() - nLevel > 1 ) {
+        const size_t nCount = m_nodes.size() - nLevel;
+        internal::SortTiles(m_nodes.data() + nLevel, nCount);
+        internal::AddParents(m_nodes.data() + nLevel, nCount, nLevel, m_nodes);
+        nLevel += nCount;
+    }
+    ASSERT(m_nodes.size() == nNodes);
+}
+
+void CListIndex::GetView(CListIndexView &view) const
+{
+    ASSERT(m_bBuilt);
+    view.m_pItems     = m_items.data();
+    view.m_nItems     = m_items.size();
+    view.m_pNodes     = m_nodes.data();
+    view.m_nNodes     = m_nodes.size();
+    view.m_nLeafNodes = m_nLeafNodes;
+}
+
+void CListIndexView::Query(const RECT &rect, std::vector<const CListItem *> &items) const
+{
+    items.clear();
+    if ( !m_nNodes ) {
+        return;
+    }
+    size_t stack[GDC_LIST_NODE_SIZE * 16]; // depth is log16 of the items
+    size_t nStack = 0;
+    stack[nStack++] = m_nNodes - 1;
+    while ( nStack ) {
+        const CListNode &node = m_pNodes[stack[--nStack]];
+        if ( !internal::Intersects(node, rect) ) {
+            continue;
+        }
+        const size_t nEnd = (size_t)node.m_nFirst + node.m_nCount;
+        if ( &node < m_pNodes + m_nLeafNodes ) {
+            if ( nEnd > m_nItems ) {
+                ASSERT(FALSE); // damaged index
+                continue;
+            }
+            for (size_t i = node.m_nFirst; i < nEnd; ++i) {
+                if ( internal::Intersects(m_pItems[i], rect) ) {
+                    items.push_back(m_pItems + i);
+                }
+            }
+        }
+        else {
+            // children are below the parent, the stack can not overflow with the valid tree
+            if ( nEnd > (size_t)(&node - m_pNodes) || nStack + node.m_nCount > sizeof(stack) / sizeof(stack[0]) ) {
+                ASSERT(FALSE);
+                continue;
+            }
+            for (size_t i = node.m_nFirst; i < nEnd; ++i) {
+                stack[nStack++] = i;
+            }
+        }
+    }
+    std::sort(items.begin(), items.end(), [](const CListItem *a, const CListItem *b) { return a->m_nOffset < b->m_nOffset; });
+}
@@ -0,0 +1,94 @@
+#ifndef __LIST_INDEX_H__
+#define __LIST_INDEX_H__
+#pragma once
+
+#include "vector"
+#include "stdint.h"
+
+// Recorded drawing command and its bounds (GDC units with the recorded viewport origin, stroke included).
+// Layout is stored in the display list file as is.
+class CListItem final
+{
+// Operations
+public:
+    void Add(int32_t x, int32_t y) {
+        m_nMinX = x < m_nMinX ? x : m_nMinX;
+        m_nMinY = y < m_nMinY ? y : m_nMinY;
+        m_nMaxX = x > m_nMaxX ? x : m_nMaxX;
+        m_nMaxY = y > m_nMaxY ? y : m_nMaxY;
+    }
+    void Pad(int32_t nPad);
+    void Offset(int32_t dx, int32_t dy);
+    bool IsEmpty() const { return m_nMinX > m_nMaxX; }
+
+// Attributes
+public:
+    uint64_t m_nOffset {0}; // command stream
+    int32_t m_xLast {0};    // delta coding state at the m_nOffset
+    int32_t m_yLast {0};
+    int32_t m_nMinX {INT32_MAX};
+    int32_t m_nMinY {INT32_MAX};
+    int32_t m_nMaxX {INT32_MIN};
+    int32_t m_nMaxY {INT32_MIN};
+};
+
+// R-tree node: children are the items (leaf level) or the nodes of the level below
+class CListNode final
+{
+// Attributes
+public:
+    int32_t m_nMinX;
+    int32_t m_nMinY;
+    int32_t m_nMaxX;
+    int32_t m_nMaxY;
+    uint32_t m_nFirst;
+    uint32_t m_nCount;
+};
+
+// Packed R-tree over the items: leaf nodes go first, the root is the last node
+class CListIndexView final
+{
+// Operations
+public:
+    // items intersecting the rect in the draw order
+    void Query(const RECT &rect, std::vector<const CListItem *> &items) const;
+
+// Attributes
+public:
+    const CListItem *m_pItems {nullptr};
+    size_t m_nItems {0};
+    const CListNode *m_pNodes {nullptr};
+    size_t m_nNodes {0};
+    size_t m_nLeafNodes {0};
+};
+
+// Spatial index of the display list: items are collected by the recorder in the draw order,
+// the tree is bulk loaded with the Sort-Tile-Recursive packing (items are reordered).
+class CListIndex final
+{
+// Construction/Destruction
+public:
+    CListIndex() { }
+    ~CListIndex() { }
+
+private:
+    CListIndex(const CListIndex &index);
+
+// Operations
+public:
+    void AddItem(const CListItem &item) {
+        m_items.push_back(item);
+        m_bBuilt = false;
+    }
+    void Build();
+    void GetView(CListIndexView &view) const;
+
+// Attributes
+private:
+    std::vector<CListItem> m_items;
+    std::vector<CListNode> m_nodes;
+    size_t m_nLeafNodes {0};
+    bool m_bBuilt {true};
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef __LIST_OPS_H__
+#define __LIST_OPS_H__
+#pragma once
+
+// Display list commands: opcode byte + arguments (ListStream.h encoding).
+// Values are stored -> new commands are appended only.
+enum GDCListOp
+{
+    GDC_LIST_DEF_PAINT               = 0,  // id, paint (before the first use)
+    GDC_LIST_DEF_PATH                = 1,  // id, path (before the first use)
+
+    GDC_LIST_LINE                    = 2,
+    GDC_LIST_POINT                   = 3,
+    GDC_LIST_POLYGON                 = 4,
+    GDC_LIST_POLY                    = 5,
+    GDC_LIST_POLYLINE                = 6,
+    GDC_LIST_POLYGON_TRANSPARENT     = 7,
+    GDC_LIST_POLYGON_GRADIENT        = 8,
+    GDC_LIST_POLYGON_TEXTURE         = 9,
+    GDC_LIST_POLYGON_TEXTURE_EXCLUDE = 10,
+    GDC_LIST_FILLED_RECTANGLE        = 11,
+    GDC_LIST_RECTANGLE               = 12,
+    GDC_LIST_LINES                   = 13,
+    GDC_LIST_RECTS                   = 14,
+    GDC_LIST_POINTS                  = 15,
+    GDC_LIST_LINE_F                  = 16,
+    GDC_LIST_POLYLINE_F              = 17,
+    GDC_LIST_POLYGON_F               = 18,
+    GDC_LIST_PATH                    = 19, // flags (1 - fill, 2 - stroke), path id, paint ids
+    GDC_LIST_ELLIPSE                 = 20,
+    GDC_LIST_FILLED_ELLIPSE          = 21,
+    GDC_LIST_HOLLOW_OVAL             = 22,
+    GDC_LIST_ARC                     = 23,
+    GDC_LIST_BITMAP                  = 24, // HBITMAP is not owned -> must outlive the list
+    GDC_LIST_TEXT_OUT                = 25,
+    GDC_LIST_DRAW_TEXT               = 26,
+    GDC_LIST_TEXT_BY_ELLIPSE         = 27,
+    GDC_LIST_TEXT_BY_CIRCLE          = 28,
+
+    GDC_LIST_VIEWPORT_ORG            = 29,
+    GDC_LIST_CURVE_TOLERANCE         = 30,
+    GDC_LIST_BEGIN_GROUP             = 31,
+    GDC_LIST_END_GROUP               = 32
+};
+
+#endif
@@ -0,0 +1,517 @@
+#include "stdafx.h"
+#include "ListPlayer.h"
+
+#include "../AbsGDC.h"
+
+#include "ListOps.h"
+#include "ListStream.h"
+#include "ListResources.h"
+#include "HitTestGDC.h"
+#include "HashGDC.h"
+
+#include "algorithm"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+void CListPlayer::ReadPoints(CListReader &reader, std::vector<GDCPoint> &points)
+{
+    size_t nCount = (size_t)reader.Uint();
+    if ( nCount > reader.GetRemaining() / 2 ) { // point takes 2 bytes at least
+        ASSERT(FALSE);
+        reader.SetError(); // following bytes are not the commands
+        nCount = 0;
+    }
+    points.resize(nCount);
+    for (GDCPoint &pt : points) {
+        reader.Point(pt.x, pt.y);
+    }
+}
+
+void CListPlayer::ReadPointsF(CListReader &reader)
+{
+    size_t nCount = (size_t)reader.Uint();
+    if ( nCount > reader.GetRemaining() / sizeof(GDCPointF) ) {
+        ASSERT(FALSE);
+        reader.SetError(); // following bytes are not the commands
+        nCount = 0;
+    }
+    m_points_f.resize(nCount);
+    reader.Raw(m_points_f.data(), nCount * sizeof(GDCPointF));
+}
+
+void CListPlayer::ReadDefs(const CListSections &sections)
+{
+    if ( m_resources.m_nDefsSize >= sections.m_nDefsSize ) {
+        return;
+    }
+    CListReader reader(sections.m_pDefs + m_resources.m_nDefsSize, sections.m_nDefsSize - m_resources.m_nDefsSize);
+    while ( !reader.IsEnd() ) {
+        const uint8_t nOp = reader.Byte();
+        if ( !ReadDef(reader, nOp) ) {
+            ASSERT(FALSE);
+            break;
+        }
+    }
+    m_resources.m_nDefsSize = sections.m_nDefsSize;
+}
+
+bool CListPlayer::ReadDef(CListReader &reader, uint8_t nOp)
+{
+    if ( nOp != GDC_LIST_DEF_PAINT && nOp != GDC_LIST_DEF_PATH ) {
+        return false;
+    }
+    const uint64_t nId   = reader.Uint();
+    const size_t nLength = (size_t)reader.Uint();
+    if ( reader.IsError() || nLength > reader.GetRemaining() ) {
+        return false;
+    }
+    const size_t nDecoded = (nOp == GDC_LIST_DEF_PAINT) ? m_resources.m_paints.size() : m_resources.m_paths.size();
+    ASSERT(nId == nDecoded);
+    if ( nId == nDecoded ) {
+        CListReader def_reader(reader.Pos(), nLength);
+        if ( nOp == GDC_LIST_DEF_PAINT ) {
+            m_resources.ReadPaint(def_reader);
+        }
+        else {
+            m_resources.ReadPath(def_reader);
+        }
+    }
+    reader.Skip(nLength);
+    return true;
+}
+
+void CListPlayer::ReplayCommands(const uint8_t *pData, size_t nSize, int32_t xLast, int32_t yLast, CAbsGDC *pDC)
+{
+    CListReader reader(pData, nSize);
+    reader.SetLastPoint(xLast, yLast);
+    while ( !reader.IsEnd() ) {
+        const uint8_t nOp = reader.Byte();
+        if ( !ReplayCommand(reader, nOp, pDC) ) {
+            ASSERT(FALSE);
+            return;
+        }
+    }
+}
+
+void CListPlayer::Replay(const CListSections &sections, CAbsGDC *pDC)
+{
+    ReadDefs(sections);
+    ReplayCommands(sections.m_pCommands, sections.m_nCommandsSize, 0, 0, pDC);
+}
+
+void CListPlayer::ReplayGroup(const CListSections &sections, size_t iGroup, CAbsGDC *pDC)
+{
+    ASSERT(iGroup < sections.m_nGroups);
+    if ( iGroup >= sections.m_nGroups ) {
+        return;
+    }
+    const GDCListGroup &group = sections.m_pGroups[iGroup];
+    const uint64_t nEnd = group.m_nEnd ? group.m_nEnd : sections.m_nCommandsSize; // not closed -> up to the end
+    if ( group.m_nBegin > nEnd || nEnd > sections.m_nCommandsSize ) {
+        ASSERT(FALSE); // damaged index
+        return;
+    }
+    ReadDefs(sections);
+    ReplayCommands(sections.m_pCommands + group.m_nBegin, (size_t)(nEnd - group.m_nBegin), group.m_xLast, group.m_yLast, pDC);
+}
+
+void CListPlayer::ReplayRegion(const CListSections &sections, const RECT &rect, CAbsGDC *pDC)
+{
+    ReadDefs(sections);
+    sections.m_index.Query(rect, m_items);
+    for (const CListItem *pItem : m_items) {
+        if ( pItem->m_nOffset >= sections.m_nCommandsSize ) {
+            ASSERT(FALSE); // damaged index
+            continue;
+        }
+        CListReader reader(sections.m_pCommands + pItem->m_nOffset, sections.m_nCommandsSize - (size_t)pItem->m_nOffset);
+        reader.SetLastPoint(pItem->m_xLast, pItem->m_yLast);
+        if ( !ReplayCommand(reader, reader.Byte(), pDC) ) {
+            ASSERT(FALSE);
+            return;
+        }
+    }
+}
+
+bool CListPlayer::HitTest(const CListSections &sections, int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit)
+{
+    ReadDefs(sections);
+    nTolerance = ::abs(nTolerance);
+    RECT rect;
+    rect.left   = (int32_t)(std::max)((int64_t)x - nTolerance, (int64_t)INT32_MIN);
+    rect.top    = (int32_t)(std::max)((int64_t)y - nTolerance, (int64_t)INT32_MIN);
+    rect.right  = (int32_t)(std::min)((int64_t)x + nTolerance, (int64_t)INT32_MAX);
+    rect.bottom = (int32_t)(std::min)((int64_t)y + nTolerance, (int64_t)INT32_MAX);
+    sections.m_index.Query(rect, m_items);
+
+    CHitTestGDC hit_gdc(x, y, nTolerance);
+    // viewport commands are indexed with the full extent -> origin of every candidate comes from the draw order pass
+    m_origins.resize(m_items.size());
+    for (size_t i = 0; i < m_items.size(); ++i) {
+        const uint64_t nOffset = m_items[i]->m_nOffset;
+        if ( nOffset < sections.m_nCommandsSize && sections.m_pCommands[nOffset] == GDC_LIST_VIEWPORT_ORG ) {
+            CListReader reader(sections.m_pCommands + nOffset, sections.m_nCommandsSize - (size_t)nOffset);
+            VERIFY(ReplayCommand(reader, reader.Byte(), &hit_gdc));
+        }
+        m_origins[i].x = hit_gdc.GetViewportOrg().x;
+        m_origins[i].y = hit_gdc.GetViewportOrg().y;
+    }
+    for (size_t i = m_items.size(); i-- > 0; ) {
+        const CListItem *pItem = m_items[i];
+        if ( pItem->m_nOffset >= sections.m_nCommandsSize ) {
+            ASSERT(FALSE); // damaged index
+            continue;
+        }
+        CListReader reader(sections.m_pCommands + pItem->m_nOffset, sections.m_nCommandsSize - (size_t)pItem->m_nOffset);
+        reader.SetLastPoint(pItem->m_xLast, pItem->m_yLast);
+        hit_gdc.SetViewportOrg(m_origins[i].x, m_origins[i].y);
+        if ( !ReplayCommand(reader, reader.Byte(), &hit_gdc) ) {
+            ASSERT(FALSE);
+            return false;
+        }
+        if ( hit_gdc.IsHit() ) {
+            hit.m_nOffset       = pItem->m_nOffset;
+            hit.m_bounds.left   = pItem->m_nMinX;
+            hit.m_bounds.top    = pItem->m_nMinY;
+            hit.m_bounds.right  = pItem->m_nMaxX;
+            hit.m_bounds.bottom = pItem->m_nMaxY;
+            hit.m_iGroup        = FindGroup(sections, pItem->m_nOffset);
+            hit.m_sGroupAttributes = hit.m_iGroup != SIZE_MAX ? GetGroupAttributes(sections, hit.m_iGroup) : std::string();
+            return true;
+        }
+    }
+    return false;
+}
+
+const CListDigest &CListPlayer::GetDigest(const CListSections &sections)
+{
+    CListDigest &digest = m_resources.m_digest;
+    if ( digest.IsValid(sections) ) {
+        return digest;
+    }
+    ReadDefs(sections);
+    const CListIndexView &index = sections.m_index;
+    digest.m_order.resize(index.m_nItems);
+    for (size_t i = 0; i < index.m_nItems; ++i) {
+        digest.m_order[i] = (uint32_t)i;
+    }
+    std::sort(digest.m_order.begin(), digest.m_order.end(), [&index](uint32_t a, uint32_t b) {
+        return index.m_pItems[a].m_nOffset < index.m_pItems[b].m_nOffset;
+    });
+
+    digest.m_hashes.resize(index.m_nItems);
+    CHashGDC hash_gdc;
+    for (size_t i = 0; i < digest.m_order.size(); ++i) {
+        const CListItem &item = index.m_pItems[digest.m_order[i]];
+        hash_gdc.Reset();
+        if ( item.m_nOffset < sections.m_nCommandsSize ) {
+            CListReader reader(sections.m_pCommands + item.m_nOffset, sections.m_nCommandsSize - (size_t)item.m_nOffset);
+            reader.SetLastPoint(item.m_xLast, item.m_yLast);
+            VERIFY(ReplayCommand(reader, reader.Byte(), &hash_gdc));
+        }
+        else {
+            ASSERT(FALSE); // damaged index
+        }
+        digest.m_hashes[i] = hash_gdc.GetHash();
+    }
+    digest.BuildGroups(sections);
+    return digest;
+}
+
+std::string CListPlayer::GetGroupAttributes(const CListSections &sections, size_t iGroup)
+{
+    std::string sAttributes;
+    ASSERT(iGroup < sections.m_nGroups);
+    if ( iGroup >= sections.m_nGroups ) {
+        return sAttributes;
+    }
+    const uint64_t nBegin = sections.m_pGroups[iGroup].m_nBegin;
+    if ( nBegin >= sections.m_nCommandsSize ) {
+        ASSERT(FALSE);
+        return sAttributes;
+    }
+    CListReader reader(sections.m_pCommands + nBegin, sections.m_nCommandsSize - (size_t)nBegin);
+    if ( reader.Byte() == GDC_LIST_BEGIN_GROUP ) {
+        reader.String(sAttributes);
+    }
+    return sAttributes;
+}
+
+size_t CListPlayer::FindGroup(const CListSections &sections, uint64_t nOffset)
+{
+    // groups are in the m_nBegin order: last group which begins before the command,
+    // if it is closed before the command -> its parents (lower depth) only
+    const GDCListGroup *pBegin = sections.m_pGroups;
+    const GDCListGroup *pEnd   = sections.m_pGroups + sections.m_nGroups;
+    const GDCListGroup *pFound = std::upper_bound(pBegin, pEnd, nOffset, [](uint64_t nValue, const GDCListGroup &group) {
+        return nValue < group.m_nBegin;
+    });
+    uint32_t nMaxDepth = UINT32_MAX;
+    while ( pFound != pBegin ) {
+        const GDCListGroup &group = *--pFound;
+        if ( group.m_nDepth >= nMaxDepth ) {
+            continue;
+        }
+        if ( group.m_nEnd == 0 || nOffset < group.m_nEnd ) {
+            return (size_t)(pFound - pBegin);
+        }
+        if ( group.m_nDepth == 0 ) {
+            break;
+        }
+        nMaxDepth = group.m_nDepth;
+    }
+    return SIZE_MAX;
+}
+
+bool CListPlayer::ReplayCommand(CListReader &reader, uint8_t nOp, CAbsGDC *pDC)
+{
+    int32_t x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+    switch ( nOp )
+    {
+    case GDC_LIST_LINE:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            reader.Point(x2, y2);
+            pDC->DrawLine(x1, y1, x2, y2, paint);
+        }
+        break;
+    case GDC_LIST_POINT:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            pDC->DrawPoint(x1, y1, paint);
+        }
+        break;
+    case GDC_LIST_POLYGON:
+        {
+            const GDCPaint &fill_paint   = m_resources.GetPaint(reader.Uint());
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPolygon(m_points, fill_paint, stroke_paint);
+        }
+        break;
+    case GDC_LIST_POLY:
+        {
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPoly(m_points, stroke_paint);
+        }
+        break;
+    case GDC_LIST_POLYLINE:
+        {
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPolyLine(m_points, stroke_paint);
+        }
+        break;
+    case GDC_LIST_POLYGON_TRANSPARENT:
+        {
+            const GDCPaint &fill_paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPolygonTransparent(m_points, fill_paint);
+        }
+        break;
+    case GDC_LIST_POLYGON_GRADIENT:
+        {
+            const GDCPaint &paintFrom = m_resources.GetPaint(reader.Uint());
+            const GDCPaint &paintTo   = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPolygonGradient(m_points, paintFrom, paintTo);
+        }
+        break;
+    case GDC_LIST_POLYGON_TEXTURE:
+    case GDC_LIST_POLYGON_TEXTURE_EXCLUDE:
+        {
+            reader.String(m_sText);
+            const double dAngle = reader.Double();
+            const float fZoom   = reader.Float();
+            ReadPoints(reader, m_points);
+            if ( nOp == GDC_LIST_POLYGON_TEXTURE ) {
+                pDC->DrawPolygonTexture(m_points, m_sText.c_str(), dAngle, fZoom);
+            }
+            else {
+                ReadPoints(reader, m_points_exclude);
+                pDC->DrawPolygonTexture(m_points, m_points_exclude, m_sText.c_str(), dAngle, fZoom);
+            }
+        }
+        break;
+    case GDC_LIST_FILLED_RECTANGLE:
+        {
+            const GDCPaint &fill_paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            reader.Point(x2, y2);
+            pDC->DrawFilledRectangle(x1, y1, x2, y2, fill_paint);
+        }
+        break;
+    case GDC_LIST_RECTANGLE:
+        {
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            reader.Point(x2, y2);
+            pDC->DrawRectangle(x1, y1, x2, y2, stroke_paint);
+        }
+        break;
+    case GDC_LIST_LINES:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawLines(m_points, paint);
+        }
+        break;
+    case GDC_LIST_RECTS:
+        {
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawRects(m_points, stroke_paint);
+        }
+        break;
+    case GDC_LIST_POINTS:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            ReadPoints(reader, m_points);
+            pDC->DrawPoints(m_points, paint);
+        }
+        break;
+    case GDC_LIST_LINE_F:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            const float fX1 = reader.Float();
+            const float fY1 = reader.Float();
+            const float fX2 = reader.Float();
+            const float fY2 = reader.Float();
+            pDC->DrawLineF(fX1, fY1, fX2, fY2, paint);
+        }
+        break;
+    case GDC_LIST_POLYLINE_F:
+        {
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPointsF(reader);
+            pDC->DrawPolyLineF(m_points_f.data(), m_points_f.size(), stroke_paint);
+        }
+        break;
+    case GDC_LIST_POLYGON_F:
+        {
+            const GDCPaint &fill_paint   = m_resources.GetPaint(reader.Uint());
+            const GDCPaint &stroke_paint = m_resources.GetPaint(reader.Uint());
+            ReadPointsF(reader);
+            pDC->DrawPolygonF(m_points_f.data(), m_points_f.size(), fill_paint, stroke_paint);
+        }
+        break;
+    case GDC_LIST_PATH:
+        {
+            const uint8_t nFlags = reader.Byte();
+            const GDCPath &path  = m_resources.GetPath(reader.Uint());
+            const GDCPaint *pFillPaint   = (nFlags & 1) ? &m_resources.GetPaint(reader.Uint()) : nullptr;
+            const GDCPaint *pStrokePaint = (nFlags & 2) ? &m_resources.GetPaint(reader.Uint()) : nullptr;
+            pDC->DrawPath(path, pFillPaint, pStrokePaint);
+        }
+        break;
+    case GDC_LIST_ELLIPSE:
+    case GDC_LIST_FILLED_ELLIPSE:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            reader.Point(x2, y2);
+            if ( nOp == GDC_LIST_ELLIPSE ) {
+                pDC->DrawEllipse(x1, y1, x2, y2, paint);
+            }
+            else {
+                pDC->DrawFilledEllipse(x1, y1, x2, y2, paint);
+            }
+        }
+        break;
+    case GDC_LIST_HOLLOW_OVAL:
+        {
+            const GDCPaint &fill_paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            const int32_t rx = reader.Int32();
+            const int32_t ry = reader.Int32();
+            const int32_t h  = reader.Int32();
+            pDC->DrawHollowOval(x1, y1, rx, ry, h, fill_paint);
+        }
+        break;
+    case GDC_LIST_ARC:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.Point(x1, y1);
+            const int32_t nRadius   = reader.Int32();
+            const float fStartAngle = reader.Float();
+            const float fSweepAngle = reader.Float();
+            pDC->DrawArc(x1, y1, nRadius, fStartAngle, fSweepAngle, paint);
+        }
+        break;
+    case GDC_LIST_BITMAP:
+        {
+            const HBITMAP hBitmap = (HBITMAP)(uintptr_t)reader.Uint();
+            reader.Point(x1, y1);
+            pDC->DrawBitmap(hBitmap, x1, y1);
+        }
+        break;
+    case GDC_LIST_TEXT_OUT:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.String(m_sText);
+            reader.Point(x1, y1);
+            pDC->TextOut(m_sText.c_str(), x1, y1, paint);
+        }
+        break;
+    case GDC_LIST_DRAW_TEXT:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.String(m_sText);
+            reader.Point(x1, y1);
+            reader.Point(x2, y2);
+            RECT rect;
+            rect.left   = x1;
+            rect.top    = y1;
+            rect.right  = x2;
+            rect.bottom = y2;
+            pDC->DrawText(m_sText.c_str(), rect, paint);
+        }
+        break;
+    case GDC_LIST_TEXT_BY_ELLIPSE:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.String(m_sText);
+            const double dCenterAngle = reader.Double();
+            const int32_t nRadiusX    = reader.Int32();
+            const int32_t nRadiusY    = reader.Int32();
+            reader.Point(x1, y1);
+            const double dEllipseAngleRad = reader.Double();
+            pDC->DrawTextByEllipse(dCenterAngle, nRadiusX, nRadiusY, x1, y1, m_sText.c_str(), dEllipseAngleRad, paint);
+        }
+        break;
+    case GDC_LIST_TEXT_BY_CIRCLE:
+        {
+            const GDCPaint &paint = m_resources.GetPaint(reader.Uint());
+            reader.String(m_sText);
+            const double dCenterAngle = reader.Double();
+            const int32_t nRadius     = reader.Int32();
+            reader.Point(x1, y1);
+            const bool bRevertTextDir = reader.Byte() != 0;
+            pDC->DrawTextByCircle(dCenterAngle, nRadius, x1, y1, m_sText.c_str(), bRevertTextDir, paint);
+        }
+        break;
+    case GDC_LIST_VIEWPORT_ORG:
+        x1 = reader.Int32();
+        y1 = reader.Int32();
+        pDC->SetViewportOrg(x1, y1);
+        break;
+    case GDC_LIST_CURVE_TOLERANCE:
+        pDC->SetCurveTolerance(reader.Float());
+        break;
+    case GDC_LIST_BEGIN_GROUP:
+        reader.String(m_sGroup);
+        pDC->BeginGroup(m_sGroup.c_str());
+        break;
+    case GDC_LIST_END_GROUP:
+        pDC->EndGroup();
+        break;
+    default:
+        return false;
+    }
+    return !reader.IsError();
+}
@@ -0,0 +1,86 @@
+#ifndef __LIST_PLAYER_H__
+#define __LIST_PLAYER_H__
+#pragma once
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+#ifndef __LIST_INDEX_H__
+    #include "ListIndex.h"
+#endif
+
+#include "vector"
+#include "string"
+
+class CAbsGDC;
+class CListReader;
+class CListResources;
+class CListDigest;
+
+// Sections of the recorded drawing: in memory display list or the mapped file
+class CListSections final
+{
+// Attributes
+public:
+    const uint8_t *m_pDefs {nullptr};
+    size_t m_nDefsSize {0};
+    const uint8_t *m_pCommands {nullptr};
+    size_t m_nCommandsSize {0};
+    const GDCListGroup *m_pGroups {nullptr};
+    size_t m_nGroups {0};
+    CListIndexView m_index;
+};
+
+// Replays the display list command stream into the backend
+class CListPlayer final
+{
+// Construction/Destruction
+public:
+    CListPlayer(CListResources &resources) : m_resources(resources) { }
+    ~CListPlayer() { }
+
+private:
+    CListPlayer(const CListPlayer &player);
+
+// Static operations
+public:
+    // BeginGroup attributes of the group
+    static std::string GetGroupAttributes(const CListSections &sections, size_t iGroup);
+    // innermost group which contains the command, SIZE_MAX: none
+    static size_t FindGroup(const CListSections &sections, uint64_t nOffset);
+
+// Operations
+public:
+    // definitions which are not decoded yet, then the commands
+    void Replay(const CListSections &sections, CAbsGDC *pDC);
+    void ReplayGroup(const CListSections &sections, size_t iGroup, CAbsGDC *pDC);
+    void ReplayRegion(const CListSections &sections, const RECT &rect, CAbsGDC *pDC);
+    // index candidates are replayed into the CHitTestGDC from the topmost one
+    bool HitTest(const CListSections &sections, int32_t x, int32_t y, int32_t nTolerance, GDCListHit &hit);
+    // digest is built once and kept in the resources
+    const CListDigest &GetDigest(const CListSections &sections);
+
+private:
+    void ReadDefs(const CListSections &sections);
+    void ReplayCommands(const uint8_t *pData, size_t nSize, int32_t xLast, int32_t yLast, CAbsGDC *pDC);
+    // returns false on the unknown command (stream is damaged or newer)
+    bool ReplayCommand(CListReader &reader, uint8_t nOp, CAbsGDC *pDC);
+    bool ReadDef(CListReader &reader, uint8_t nOp);
+    void ReadPoints(CListReader &reader, std::vector<GDCPoint> &points);
+    void ReadPointsF(CListReader &reader);
+
+// Attributes
+private:
+    CListResources &m_resources;
+    // scratch buffers are reused by the commands
+    std::vector<GDCPoint> m_points;
+    std::vector<GDCPoint> m_points_exclude;
+    std::vector<GDCPointF> m_points_f;
+    std::wstring m_sText;
+    std::string m_sGroup;
+    std::vector<const CListItem *> m_items;
+    std::vector<GDCPoint> m_origins; // hit test: viewport origin of the m_items
+};
+
+#endif
@@ -0,0 +1,171 @@
+#include "stdafx.h"
+#include "ListResources.h"
+
+#include "ListStream.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+void CListResources::WritePaint(CListWriter &writer, const GDCPaint &paint)
+{
+    writer.Uint(paint.GetColor());
+    writer.Uint(paint.GetBkColor());
+    writer.Int(paint.GetAlfa());
+    writer.Float(paint.GetStrokeWidth());
+    writer.Uint(paint.GetStrokeType());
+    writer.Uint(paint.GetPaintType());
+    writer.Uint(paint.GetRasterType());
+    writer.Uint(paint.GetBkMode());
+
+    const GDCFontDescr *pFont = paint.GetFontDescr();
+    writer.Byte(pFont ? 1 : 0);
+    if ( pFont ) {
+        writer.String(pFont->m_sFontName.c_str(), pFont->m_sFontName.size());
+        writer.Float(pFont->m_fAngle);
+        writer.Uint(pFont->m_weight);
+        writer.Int(pFont->m_nHeight);
+        writer.Int(pFont->m_nSlant);
+        writer.Int(pFont->m_nUnderline);
+        writer.Int(pFont->m_nTextAlign);
+    }
+}
+
+void CListResources::ReadPaint(CListReader &reader)
+{
+    const COLORREF color           = (COLORREF)reader.Uint();
+    const COLORREF bk_color        = (COLORREF)reader.Uint();
+    const int32_t nAlfa            = reader.Int32();
+    const float fWidth             = reader.Float();
+    // damaged values -> defaults
+    const uint64_t nStroke         = reader.Uint();
+    const GDCStrokeType stroke     = nStroke <= GDC_PS_DASHDOTDOT ? (GDCStrokeType)nStroke : GDC_PS_SOLID;
+    const uint64_t nPaintType      = reader.Uint();
+    const GDCPaintType paint_type  = nPaintType <= GDC_FILL_CROSS ? (GDCPaintType)nPaintType : GDC_STROKE;
+    const uint64_t nRaster         = reader.Uint();
+    const GDCRasterType raster     = nRaster <= GDC_R2_NOTXORPEN ? (GDCRasterType)nRaster : GDC_R2_NONE;
+    const uint64_t nBk             = reader.Uint();
+    const GDCBackgroundMode bk     = nBk == GDC_OPAQUE ? GDC_OPAQUE : GDC_TRANSPARENT;
+
+    if ( reader.Byte() ) {
+        std::wstring sFontName;
+        reader.String(sFontName);
+        const float fAngle = reader.Float();
+        const uint64_t nWeight     = reader.Uint();
+        const GDCFontWeight weight = nWeight <= GDC_FW_BOLD ? (GDCFontWeight)nWeight : GDC_FW_NORMAL;
+        const int32_t nHeight      = reader.Int32();
+        const int32_t nSlant       = reader.Int32();
+        const int32_t nUnderline   = reader.Int32();
+        GDCFontDescr font_descr(sFontName.c_str(), weight, nHeight, nSlant, nUnderline);
+        font_descr.m_fAngle     = fAngle;
+        font_descr.m_nTextAlign = reader.Int32();
+        m_paints.emplace_back(font_descr);
+    }
+    else {
+        m_paints.emplace_back();
+    }
+
+    GDCPaint &paint = m_paints.back();
+    paint.SetColor(color);
+    paint.SetBkColor(bk_color);
+    paint.SetAlfa(nAlfa);
+    paint.SetStrokeWidth(fWidth);
+    paint.SetStrokeType(stroke);
+    paint.SetPaintType(paint_type);
+    paint.SetRasterType(raster);
+    paint.SetBkMode(bk);
+}
+
+// verb by verb, the points are the deltas
+void CListResources::WritePath(CListWriter &writer, const GDCPath &path)
+{
+    const std::vector<uint8_t> &verbs   = path.GetVerbs();
+    const std::vector<GDCPoint> &points = path.GetPoints();
+    const std::vector<GDCPathArc> &arcs = path.GetArcs();
+    writer.Uint(path.GetFillRule());
+    writer.Uint(verbs.size());
+    size_t iPoint = 0;
+    size_t iArc   = 0;
+    for (const uint8_t verb : verbs)
+    {
+        writer.Byte(verb);
+        switch ( verb )
+        {
+        case GDC_PATH_MOVE:
+        case GDC_PATH_LINE:
+            writer.Point(points[iPoint].x, points[iPoint].y);
+            ++iPoint;
+            break;
+        case GDC_PATH_QUAD:
+        case GDC_PATH_CUBIC:
+            {
+                const size_t nCount = (verb == GDC_PATH_QUAD) ? 2 : 3;
+                for (size_t i = 0; i < nCount; ++i, ++iPoint) {
+                    writer.Point(points[iPoint].x, points[iPoint].y);
+                }
+            }
+            break;
+        case GDC_PATH_ARC:
+            {
+                const GDCPathArc &arc = arcs[iArc++];
+                writer.Point(arc.m_center.x, arc.m_center.y);
+                writer.Int(arc.m_nRadius);
+                writer.Float(arc.m_fStartAngle);
+                writer.Float(arc.m_fSweepAngle);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void CListResources::ReadPath(CListReader &reader)
+{
+    m_paths.emplace_back();
+    GDCPath &path = m_paths.back();
+    path.SetFillRule(reader.Uint() == GDC_FILL_RULE_EVENODD ? GDC_FILL_RULE_EVENODD : GDC_FILL_RULE_NONZERO);
+    const size_t nCount = (size_t)reader.Uint();
+    GDCPoint pt[3];
+    for (size_t i = 0; i < nCount && !reader.IsEnd(); ++i)
+    {
+        const uint8_t verb = reader.Byte();
+        switch ( verb )
+        {
+        case GDC_PATH_MOVE:
+            reader.Point(pt[0].x, pt[0].y);
+            path.MoveTo(pt[0]);
+            break;
+        case GDC_PATH_LINE:
+            reader.Point(pt[0].x, pt[0].y);
+            path.LineTo(pt[0]);
+            break;
+        case GDC_PATH_QUAD:
+            reader.Point(pt[0].x, pt[0].y);
+            reader.Point(pt[1].x, pt[1].y);
+            path.QuadTo(pt[0].x, pt[0].y, pt[1].x, pt[1].y);
+            break;
+        case GDC_PATH_CUBIC:
+            reader.Point(pt[0].x, pt[0].y);
+            reader.Point(pt[1].x, pt[1].y);
+            reader.Point(pt[2].x, pt[2].y);
+            path.CubicTo(pt[0].x, pt[0].y, pt[1].x, pt[1].y, pt[2].x, pt[2].y);
+            break;
+        case GDC_PATH_ARC:
+            {
+                reader.Point(pt[0].x, pt[0].y);
+                const int32_t nRadius    = reader.Int32();
+                const float fStartAngle  = reader.Float();
+                const float fSweepAngle  = reader.Float();
+                path.Arc(pt[0].x, pt[0].y, nRadius, fStartAngle, fSweepAngle);
+            }
+            break;
+        case GDC_PATH_CLOSE:
+            path.Close();
+            break;
+        default:
+            ASSERT(FALSE);
+            return;
+        }
+    }
+}
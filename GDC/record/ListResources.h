@@ -0,0 +1,60 @@
+#ifndef __LIST_RESOURCES_H__
+#define __LIST_RESOURCES_H__
+#pragma once
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+#ifndef __LIST_DIGEST_H__
+    #include "ListDigest.h"
+#endif
+
+#include "deque"
+
+class CListWriter;
+class CListReader;
+
+// Paints and paths of the display list decoded by the replay. Objects stay alive between the replays
+// -> backend paint handles and prepared paths are created once. deque: GDCPaint is not copyable.
+class CListResources final
+{
+// Construction/Destruction
+public:
+    CListResources() { }
+    ~CListResources() { }
+
+// Static operations
+public:
+    // payload of the GDC_LIST_DEF_PAINT, GDC_LIST_DEF_PATH
+    static void WritePaint(CListWriter &writer, const GDCPaint &paint);
+    static void WritePath(CListWriter &writer, const GDCPath &path);
+
+// Operations
+public:
+    void ReadPaint(CListReader &reader);
+    void ReadPath(CListReader &reader);
+
+    // invalid id (damaged stream) -> default objects
+    const GDCPaint &GetPaint(uint64_t nId) const {
+        ASSERT(nId < m_paints.size());
+        return nId < m_paints.size() ? m_paints[(size_t)nId] : m_default_paint;
+    }
+    const GDCPath &GetPath(uint64_t nId) const {
+        ASSERT(nId < m_paths.size());
+        return nId < m_paths.size() ? m_paths[(size_t)nId] : m_default_path;
+    }
+
+// Attributes
+public:
+    std::deque<GDCPaint> m_paints;
+    std::deque<GDCPath> m_paths;
+    size_t m_nDefsSize {0}; // decoded part of the definitions (append only)
+    CListDigest m_digest;   // CListPlayer::GetDigest
+
+private:
+    GDCPaint m_default_paint;
+    GDCPath m_default_path;
+};
+
+#endif
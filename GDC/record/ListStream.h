@@ -0,0 +1,189 @@
+#ifndef __LIST_STREAM_H__
+#define __LIST_STREAM_H__
+#pragma once
+
+#include "vector"
+#include "string"
+#include "algorithm"
+#include "string.h"
+#include "wchar.h"
+
+// Display list encoding: unsigned LEB128 varints, signed values are zigzag mapped (small negatives stay short),
+// floats and doubles are stored as the raw little endian bytes.
+class CListWriter final
+{
+// Construction/Destruction
+public:
+    CListWriter(std::vector<uint8_t> &data) : m_data(data) { }
+    ~CListWriter() { }
+
+private:
+    CListWriter(const CListWriter &writer);
+
+// Operations
+public:
+    void Byte(uint8_t nValue) { m_data.push_back(nValue); }
+    void Uint(uint64_t nValue) {
+        while ( nValue >= 0x80 ) {
+            m_data.push_back((uint8_t)(nValue | 0x80));
+            nValue >>= 7;
+        }
+        m_data.push_back((uint8_t)nValue);
+    }
+    void Int(int64_t nValue) {
+        Uint(((uint64_t)nValue << 1) ^ (uint64_t)(nValue >> 63));
+    }
+    void Float(float fValue)    { Raw(&fValue, sizeof(fValue)); }
+    void Double(double dValue)  { Raw(&dValue, sizeof(dValue)); }
+    void Raw(const void *pData, size_t nSize) {
+        const uint8_t *pBytes = (const uint8_t *)pData;
+        m_data.insert(m_data.end(), pBytes, pBytes + nSize);
+    }
+    void String(const char *sValue) {
+        const size_t nLen = sValue ? ::strlen(sValue) : 0;
+        Uint(nLen);
+        Raw(sValue, nLen);
+    }
+    void String(const wchar_t *sValue, size_t nLen) {
+        Uint(nLen);
+        for (size_t i = 0; i < nLen; ++i) {
+            Uint((uint64_t)sValue[i]); // latin text -> one byte per character
+        }
+    }
+    void String(const wchar_t *sValue) {
+        String(sValue, sValue ? ::wcslen(sValue) : 0);
+    }
+
+    // coordinates are the deltas from the previous point of the stream
+    void Point(int32_t x, int32_t y) {
+        Int((int64_t)x - m_nLastX);
+        Int((int64_t)y - m_nLastY);
+        m_nLastX = x;
+        m_nLastY = y;
+    }
+    void SetLastPoint(int32_t x, int32_t y) {
+        m_nLastX = x;
+        m_nLastY = y;
+    }
+    int32_t GetLastX() const { return m_nLastX; }
+    int32_t GetLastY() const { return m_nLastY; }
+
+// Attributes
+private:
+    std::vector<uint8_t> &m_data;
+    int32_t m_nLastX {0};
+    int32_t m_nLastY {0};
+};
+
+class CListReader final
+{
+// Construction/Destruction
+public:
+    CListReader(const uint8_t *pData, size_t nSize) : m_pData(pData), m_pEnd(pData + nSize) { }
+    ~CListReader() { }
+
+// Operations
+public:
+    bool IsEnd() const       { return m_pData >= m_pEnd; }
+    // data is damaged or truncated (mapped file): reads past the end give zeros
+    bool IsError() const     { return m_bError; }
+    void SetError()          { m_bError = true; }
+    const uint8_t *Pos() const { return m_pData; }
+    size_t GetRemaining() const { return (size_t)(m_pEnd - m_pData); }
+    void Skip(size_t nSize) {
+        if ( nSize > GetRemaining() ) {
+            m_bError = true;
+            nSize = GetRemaining();
+        }
+        m_pData += nSize;
+    }
+
+    uint8_t Byte() {
+        if ( m_pData >= m_pEnd ) {
+            m_bError = true;
+            return 0;
+        }
+        return *m_pData++;
+    }
+    // 10 bytes at most (64 bits)
+    uint64_t Uint() {
+        uint64_t nValue = 0;
+        for (int32_t nShift = 0; nShift < 70; nShift += 7) {
+            if ( m_pData >= m_pEnd ) {
+                break;
+            }
+            const uint8_t nByte = *m_pData++;
+            nValue |= (uint64_t)(nByte & 0x7F) << nShift;
+            if ( !(nByte & 0x80) ) {
+                return nValue;
+            }
+        }
+        m_bError = true;
+        return nValue;
+    }
+    int64_t Int() {
+        const uint64_t nValue = Uint();
+        return (int64_t)(nValue >> 1) ^ -(int64_t)(nValue & 1);
+    }
+    int32_t Int32() { return (int32_t)Int(); }
+    float Float() {
+        float fValue = 0.f;
+        Raw(&fValue, sizeof(fValue));
+        return fValue;
+    }
+    double Double() {
+        double dValue = 0.;
+        Raw(&dValue, sizeof(dValue));
+        return dValue;
+    }
+    void Raw(void *pData, size_t nSize) {
+        const size_t nRead = (std::min)(nSize, GetRemaining());
+        if ( nRead > 0 ) { // empty vector data can be null
+            ::memcpy(pData, m_pData, nRead);
+        }
+        if ( nRead < nSize ) {
+            ::memset((uint8_t *)pData + nRead, 0, nSize - nRead);
+            m_bError = true;
+        }
+        m_pData += nRead;
+    }
+    void String(std::string &sValue) {
+        size_t nLen = (size_t)Uint(); // length goes before the remaining size
+        if ( nLen > GetRemaining() ) {
+            m_bError = true;
+            nLen = GetRemaining();
+        }
+        sValue.assign((const char *)m_pData, nLen);
+        Skip(nLen);
+    }
+    void String(std::wstring &sValue) {
+        size_t nLen = (size_t)Uint();
+        if ( nLen > GetRemaining() ) { // character takes 1 byte at least
+            m_bError = true;
+            nLen = GetRemaining();
+        }
+        sValue.resize(nLen);
+        for (size_t i = 0; i < nLen; ++i) {
+            sValue[i] = (wchar_t)Uint();
+        }
+    }
+
+    void Point(int32_t &x, int32_t &y) {
+        m_nLastX = x = (int32_t)(m_nLastX + Int());
+        m_nLastY = y = (int32_t)(m_nLastY + Int());
+    }
+    void SetLastPoint(int32_t x, int32_t y) {
+        m_nLastX = x;
+        m_nLastY = y;
+    }
+
+// Attributes
+private:
+    const uint8_t *m_pData;
+    const uint8_t *m_pEnd;
+    int32_t m_nLastX {0};
+    int32_t m_nLastY {0};
+    bool m_bError {false};
+};
+
+#endif
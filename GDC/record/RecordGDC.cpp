@@ -0,0 +1,500 @@
+#include "stdafx.h"
+#include "RecordGDC.h"
+
+#include "../GDC.h"
+
+#include "ListOps.h"
+#include "ListResources.h"
+#include "ListIndex.h"
+
+#include "../svg/SvgBoxPad.h"
+
+#include "math.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+CRecordGDC::CRecordGDC(GDCDisplayList &list)
+: m_list(list), m_writer(list.m_data), m_defs_writer(list.m_defs)
+{
+    m_writer.SetLastPoint(list.m_last.x, list.m_last.y);
+    if ( !m_list.m_pIndex ) {
+        m_list.m_pIndex = new CListIndex;
+    }
+}
+
+CRecordGDC::~CRecordGDC()
+{
+    m_list.m_pIndex->Build();
+    m_list.m_last.x = m_writer.GetLastX();
+    m_list.m_last.y = m_writer.GetLastY();
+}
+
+void CRecordGDC::BeginCommand(uint8_t nOp)
+{
+    m_item = CListItem();
+    m_item.m_nOffset = m_list.m_data.size();
+    m_item.m_xLast   = m_writer.GetLastX();
+    m_item.m_yLast   = m_writer.GetLastY();
+    m_writer.Byte(nOp);
+    ++m_list.m_nCommands;
+}
+
+void CRecordGDC::AddItem(int32_t nPad)
+{
+    if ( m_item.IsEmpty() ) {
+        return;
+    }
+    m_item.Offset(m_xOrg, m_yOrg); // index is in the replayed coordinates
+    m_item.Pad(nPad);
+    m_list.m_pIndex->AddItem(m_item);
+}
+
+// rounded outwards and clamped to the int32
+static inline int32_t GetIndexCoord(float fValue, bool bMax)
+{
+    const float fCoord = bMax ? ::ceilf(fValue) : ::floorf(fValue);
+    if ( !(fCoord > (float)INT32_MIN) ) { // NaN included
+        return bMax ? INT32_MAX : INT32_MIN;
+    }
+    return fCoord < (float)INT32_MAX ? (int32_t)fCoord : INT32_MAX;
+}
+
+uint32_t CRecordGDC::GetPaintId(const GDCPaint &paint)
+{
+    m_def.clear();
+    CListWriter def_writer(m_def);
+    CListResources::WritePaint(def_writer, paint);
+    m_sKey.assign((const char *)m_def.data(), m_def.size());
+
+    auto found = m_paint_ids.find(m_sKey);
+    if ( found != m_paint_ids.end() ) {
+        return found->second;
+    }
+    const uint32_t nId = m_list.m_nPaints++;
+    m_paint_ids.emplace(m_sKey, nId);
+    m_defs_writer.Byte(GDC_LIST_DEF_PAINT);
+    m_defs_writer.Uint(nId);
+    m_defs_writer.Uint(m_def.size());
+    m_defs_writer.Raw(m_def.data(), m_def.size());
+    return nId;
+}
+
+uint32_t CRecordGDC::GetPathId(const GDCPath &path)
+{
+    m_def.clear();
+    CListWriter def_writer(m_def);
+    CListResources::WritePath(def_writer, path);
+    m_sKey.assign((const char *)m_def.data(), m_def.size());
+
+    auto found = m_path_ids.find(m_sKey);
+    if ( found != m_path_ids.end() ) {
+        return found->second;
+    }
+    const uint32_t nId = m_list.m_nPaths++;
+    m_path_ids.emplace(m_sKey, nId);
+    m_defs_writer.Byte(GDC_LIST_DEF_PATH);
+    m_defs_writer.Uint(nId);
+    m_defs_writer.Uint(m_def.size());
+    m_defs_writer.Raw(m_def.data(), m_def.size());
+    return nId;
+}
+
+void CRecordGDC::WritePoints(const GDCPoints &points)
+{
+    m_writer.Uint(points.size());
+    for (const GDCPoint pt : points) {
+        m_writer.Point(pt.x, pt.y);
+        m_item.Add(pt.x, pt.y);
+    }
+}
+
+void CRecordGDC::WritePoints(const std::vector<GDCPoint> &points)
+{
+    WritePoints(GDCPoints(points));
+}
+
+void CRecordGDC::WritePointsF(const GDCPointF *pPoints, size_t nCount)
+{
+    m_writer.Uint(nCount);
+    m_writer.Raw(pPoints, nCount * sizeof(GDCPointF));
+    for (size_t i = 0; i < nCount; ++i) {
+        m_item.Add(::GetIndexCoord(pPoints[i].x, false), ::GetIndexCoord(pPoints[i].y, false));
+        m_item.Add(::GetIndexCoord(pPoints[i].x, true),  ::GetIndexCoord(pPoints[i].y, true));
+    }
+}
+
+// paint definitions go before the command -> ids are resolved first
+void CRecordGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_LINE);
+    m_writer.Uint(nPaint);
+    m_writer.Point(x1, y1);
+    m_writer.Point(x2, y2);
+    m_item.Add(x1, y1);
+    m_item.Add(x2, y2);
+    AddItem(::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_POINT);
+    m_writer.Uint(nPaint);
+    m_writer.Point(x, y);
+    m_item.Add(x, y);
+    AddItem((int32_t)paint.GetStrokeWidth() + 1);
+}
+
+void CRecordGDC::DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    const uint32_t nFill   = GetPaintId(fill_paint);
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_POLYGON);
+    m_writer.Uint(nFill);
+    m_writer.Uint(nStroke);
+    WritePoints(points);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_POLY);
+    m_writer.Uint(nStroke);
+    WritePoints(points);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_POLYLINE);
+    m_writer.Uint(nStroke);
+    WritePoints(points);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)
+{
+    const uint32_t nFill = GetPaintId(fill_paint);
+    BeginCommand(GDC_LIST_POLYGON_TRANSPARENT);
+    m_writer.Uint(nFill);
+    WritePoints(points);
+    AddItem(1);
+}
+
+void CRecordGDC::DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
+{
+    const uint32_t nFrom = GetPaintId(paintFrom);
+    const uint32_t nTo   = GetPaintId(paintTo);
+    BeginCommand(GDC_LIST_POLYGON_GRADIENT);
+    m_writer.Uint(nFrom);
+    m_writer.Uint(nTo);
+    WritePoints(points);
+    AddItem(::GetStrokePad(paintFrom));
+}
+
+void CRecordGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    BeginCommand(GDC_LIST_POLYGON_TEXTURE);
+    m_writer.String(sTexturePath);
+    m_writer.Double(dAngle);
+    m_writer.Float(fZoom);
+    WritePoints(points);
+    AddItem(1);
+}
+
+void CRecordGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                    const wchar_t *sTexturePath, double dAngle, float fZoom)
+{
+    BeginCommand(GDC_LIST_POLYGON_TEXTURE_EXCLUDE);
+    m_writer.String(sTexturePath);
+    m_writer.Double(dAngle);
+    m_writer.Float(fZoom);
+    WritePoints(points);
+    WritePoints(points_exclude);
+    AddItem(1);
+}
+
+void CRecordGDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint)
+{
+    const uint32_t nFill = GetPaintId(fill_paint);
+    BeginCommand(GDC_LIST_FILLED_RECTANGLE);
+    m_writer.Uint(nFill);
+    m_writer.Point(x1, y1);
+    m_writer.Point(x2, y2);
+    m_item.Add(x1, y1);
+    m_item.Add(x2, y2);
+    AddItem(1);
+}
+
+void CRecordGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint)
+{
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_RECTANGLE);
+    m_writer.Uint(nStroke);
+    m_writer.Point(x1, y1);
+    m_writer.Point(x2, y2);
+    m_item.Add(x1, y1);
+    m_item.Add(x2, y2);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_LINES);
+    m_writer.Uint(nPaint);
+    WritePoints(points);
+    AddItem(::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_RECTS);
+    m_writer.Uint(nStroke);
+    WritePoints(corners);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_POINTS);
+    m_writer.Uint(nPaint);
+    WritePoints(points);
+    AddItem((int32_t)paint.GetStrokeWidth() + 1);
+}
+
+void CRecordGDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_LINE_F);
+    m_writer.Uint(nPaint);
+    m_writer.Float(x1);
+    m_writer.Float(y1);
+    m_writer.Float(x2);
+    m_writer.Float(y2);
+    m_item.Add(::GetIndexCoord((std::min)(x1, x2), false), ::GetIndexCoord((std::min)(y1, y2), false));
+    m_item.Add(::GetIndexCoord((std::max)(x1, x2), true),  ::GetIndexCoord((std::max)(y1, y2), true));
+    AddItem(::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_POLYLINE_F);
+    m_writer.Uint(nStroke);
+    WritePointsF(pPoints, nCount);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    const uint32_t nFill   = GetPaintId(fill_paint);
+    const uint32_t nStroke = GetPaintId(stroke_paint);
+    BeginCommand(GDC_LIST_POLYGON_F);
+    m_writer.Uint(nFill);
+    m_writer.Uint(nStroke);
+    WritePointsF(pPoints, nCount);
+    AddItem(::GetStrokePad(stroke_paint));
+}
+
+void CRecordGDC::DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint)
+{
+    const uint32_t nPath   = GetPathId(path);
+    const uint32_t nFill   = pFillPaint   ? GetPaintId(*pFillPaint)   : 0;
+    const uint32_t nStroke = pStrokePaint ? GetPaintId(*pStrokePaint) : 0;
+    BeginCommand(GDC_LIST_PATH);
+    m_writer.Byte((pFillPaint ? 1 : 0) | (pStrokePaint ? 2 : 0));
+    m_writer.Uint(nPath);
+    if ( pFillPaint ) {
+        m_writer.Uint(nFill);
+    }
+    if ( pStrokePaint ) {
+        m_writer.Uint(nStroke);
+    }
+    RECT rect;
+    if ( path.GetBounds(rect) ) {
+        m_item.Add(rect.left, rect.top);
+        m_item.Add(rect.right, rect.bottom);
+        AddItem(pStrokePaint ? ::GetStrokePad(*pStrokePaint) : 1);
+    }
+}
+
+void CRecordGDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_ELLIPSE);
+    m_writer.Uint(nPaint);
+    m_writer.Point(x1, y1);
+    m_writer.Point(x2, y2);
+    m_item.Add(x1, y1);
+    m_item.Add(x2, y2);
+    AddItem(::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_FILLED_ELLIPSE);
+    m_writer.Uint(nPaint);
+    m_writer.Point(x1, y1);
+    m_writer.Point(x2, y2);
+    m_item.Add(x1, y1);
+    m_item.Add(x2, y2);
+    AddItem(::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint)
+{
+    const uint32_t nFill = GetPaintId(fill_paint);
+    BeginCommand(GDC_LIST_HOLLOW_OVAL);
+    m_writer.Uint(nFill);
+    m_writer.Point(xCenter, yCenter);
+    m_writer.Int(rx);
+    m_writer.Int(ry);
+    m_writer.Int(h);
+    m_item.Add(xCenter, yCenter);
+    AddItem((std::max)(::abs(rx), ::abs(ry)) + ::abs(h) + 1);
+}
+
+void CRecordGDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_ARC);
+    m_writer.Uint(nPaint);
+    m_writer.Point(x, y);
+    m_writer.Int(nRadius);
+    m_writer.Float(fStartAngle);
+    m_writer.Float(fSweepAngle);
+    m_item.Add(x, y);
+    AddItem(::abs(nRadius) + ::GetStrokePad(paint));
+}
+
+void CRecordGDC::DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y)
+{
+    BeginCommand(GDC_LIST_BITMAP);
+    ++m_list.m_nBitmaps; // handle is not saved into the file
+    m_writer.Uint((uint64_t)(uintptr_t)hBitmap);
+    m_writer.Point(x, y);
+    m_item.Add(INT32_MIN, INT32_MIN); // size is not known -> always replayed
+    m_item.Add(INT32_MAX, INT32_MAX);
+    AddItem(0);
+}
+
+void CRecordGDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_TEXT_OUT);
+    m_writer.Uint(nPaint);
+    m_writer.String(sText);
+    m_writer.Point(x, y);
+    m_item.Add(x, y);
+    AddItem(::GetTextPad(sText, paint));
+}
+
+void CRecordGDC::DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_DRAW_TEXT);
+    m_writer.Uint(nPaint);
+    m_writer.String(sText);
+    m_writer.Point(rect.left, rect.top);
+    m_writer.Point(rect.right, rect.bottom);
+    m_item.Add(rect.left, rect.top);
+    m_item.Add(rect.right, rect.bottom);
+    AddItem(1);
+}
+
+void CRecordGDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                   const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_TEXT_BY_ELLIPSE);
+    m_writer.Uint(nPaint);
+    m_writer.String(sText);
+    m_writer.Double(dCenterAngle);
+    m_writer.Int(nRadiusX);
+    m_writer.Int(nRadiusY);
+    m_writer.Point(xCenter, yCenter);
+    m_writer.Double(dEllipseAngleRad);
+    m_item.Add(xCenter, yCenter);
+    AddItem((std::max)(::abs(nRadiusX), ::abs(nRadiusY)) + ::GetTextPad(sText, paint));
+}
+
+void CRecordGDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                  bool bRevertTextDir, const GDCPaint &paint)
+{
+    const uint32_t nPaint = GetPaintId(paint);
+    BeginCommand(GDC_LIST_TEXT_BY_CIRCLE);
+    m_writer.Uint(nPaint);
+    m_writer.String(sText);
+    m_writer.Double(dCenterAngle);
+    m_writer.Int(nRadius);
+    m_writer.Point(nCX, nCY);
+    m_writer.Byte(bRevertTextDir ? 1 : 0);
+    m_item.Add(nCX, nCY);
+    AddItem(::abs(nRadius) + ::GetTextPad(sText, paint));
+}
+
+void CRecordGDC::SetViewportOrg(int32_t x, int32_t y)
+{
+    m_xOrg = x;
+    m_yOrg = y;
+    BeginCommand(GDC_LIST_VIEWPORT_ORG);
+    m_writer.Int(x);
+    m_writer.Int(y);
+    m_item.Add(INT32_MIN, INT32_MIN); // region replay and hit test get the origin of the following commands
+    m_item.Add(INT32_MAX, INT32_MAX);
+    AddItem(0);
+}
+
+GDCPoint CRecordGDC::GetViewportOrg() const
+{
+    return GDCPoint(m_xOrg, m_yOrg);
+}
+
+void CRecordGDC::SetCurveTolerance(float fTolerance)
+{
+    BeginCommand(GDC_LIST_CURVE_TOLERANCE);
+    m_writer.Float(fTolerance);
+}
+
+void CRecordGDC::BeginGroup(const char *sGroupAttributes)
+{
+    GDCListGroup group;
+    group.m_nBegin = m_list.m_data.size();
+    group.m_xLast  = m_writer.GetLastX();
+    group.m_yLast  = m_writer.GetLastY();
+    group.m_nDepth = (uint32_t)m_open_groups.size();
+    m_open_groups.push_back(m_list.m_groups.size());
+    m_list.m_groups.push_back(group);
+
+    BeginCommand(GDC_LIST_BEGIN_GROUP);
+    m_writer.String(sGroupAttributes);
+}
+
+void CRecordGDC::EndGroup()
+{
+    BeginCommand(GDC_LIST_END_GROUP);
+    if ( m_open_groups.empty() ) { // opened by the previous recorder -> stays open in the index
+        return;
+    }
+    m_list.m_groups[m_open_groups.back()].m_nEnd = m_list.m_data.size();
+    m_open_groups.pop_back();
+}
+
+int32_t CRecordGDC::GetTextHeight(const GDCPaint &paint) const
+{
+    return m_measure.GetTextHeight(paint);
+}
+
+GDCSize CRecordGDC::GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const
+{
+    return m_measure.GetTextExtent(sText, nCount, paint);
+}
@@ -0,0 +1,120 @@
+#ifndef __RECORD_GDC_H__
+#define __RECORD_GDC_H__
+#pragma once
+
+#ifndef __ABS_GDC_H__
+    #include "../AbsGDC.h"
+#endif
+
+#ifndef __LIST_STREAM_H__
+    #include "ListStream.h"
+#endif
+
+#ifndef __LIST_INDEX_H__
+    #include "ListIndex.h"
+#endif
+
+#ifndef __SCREEN_MEASURE_H__
+    #include "ScreenMeasure.h"
+#endif
+
+#include "unordered_map"
+#include "string"
+
+class GDCDisplayList;
+
+// Backend which records the calls into the GDCDisplayList (ListOps.h commands),
+// equal paints and paths are written once (definitions stream) and referenced by the id.
+class CRecordGDC final : public CAbsGDC
+{
+// Construction/Destruction
+public:
+    CRecordGDC(GDCDisplayList &list);
+    virtual ~CRecordGDC();
+
+private:
+    CRecordGDC(const CRecordGDC &gdc);
+
+// Overrides
+public:
+    virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override;
+
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override;
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                    const wchar_t *sTexturePath, double dAngle, float fZoom) override;
+
+    virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override;
+    virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &stroke_paint) override;
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override;
+
+    virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+    virtual void DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint) override;
+    virtual void DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint) override;
+
+    virtual void DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y) override;
+
+    virtual void TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint) override;
+    virtual void DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint) override;
+    virtual void DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                   const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint) override;
+    virtual void DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                  bool bRevertTextDir, const GDCPaint &paint) override;
+
+    // measured with the screen dc (as svg)
+    virtual int32_t GetTextHeight(const GDCPaint &paint) const override;
+    virtual GDCSize GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const override;
+
+    virtual void SetViewportOrg(int32_t x, int32_t y) override;
+    virtual GDCPoint GetViewportOrg() const override;
+
+    virtual void SetCurveTolerance(float fTolerance) override;
+
+    virtual void BeginGroup(const char *sGroupAttributes) override;
+    virtual void EndGroup() override;
+
+    virtual HDC GetHDC() override { return nullptr; }
+
+private:
+    void BeginCommand(uint8_t nOp);
+    // bounds of the command (m_item) are padded and indexed
+    void AddItem(int32_t nPad);
+    // id of the paint, definition is written on the first use
+    uint32_t GetPaintId(const GDCPaint &paint);
+    uint32_t GetPathId(const GDCPath &path);
+    void WritePoints(const GDCPoints &points);
+    void WritePoints(const std::vector<GDCPoint> &points);
+    void WritePointsF(const GDCPointF *pPoints, size_t nCount);
+
+// Attributes
+private:
+    GDCDisplayList &m_list;
+    CListWriter m_writer;      // commands
+    CListWriter m_defs_writer; // paint and path definitions
+    int32_t m_xOrg {0};
+    int32_t m_yOrg {0};
+    CListItem m_item; // command being recorded
+
+    std::vector<uint8_t> m_def;  // resource being interned
+    std::string m_sKey;
+    std::unordered_map<std::string, uint32_t> m_paint_ids;
+    std::unordered_map<std::string, uint32_t> m_path_ids;
+    std::vector<size_t> m_open_groups; // GDCDisplayList::m_groups indices
+    mutable CScreenMeasure m_measure;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#include "stdafx.h"
+#include "ScreenMeasure.h"
+
+#include "../GDI/oligdi.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+CScreenMeasure::~CScreenMeasure()
+{
+    delete m_pGDC;
+    delete m_pDC;
+}
+
+GDC &CScreenMeasure::GetGDC()
+{
+    if ( !m_pGDC ) {
+        m_pDC  = new OWindowDC(nullptr); // screen
+        m_pGDC = new GDC(m_pDC->GetSafeHdc());
+    }
+    return *m_pGDC;
+}
+
+int32_t CScreenMeasure::GetTextHeight(const GDCPaint &paint)
+{
+    return GetGDC().GetTextHeight(paint);
+}
+
+GDCSize CScreenMeasure::GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint)
+{
+    return GetGDC().GetTextExtent(sText, nCount, paint);
+}
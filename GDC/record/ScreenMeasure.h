@@ -0,0 +1,37 @@
+#ifndef __SCREEN_MEASURE_H__
+#define __SCREEN_MEASURE_H__
+#pragma once
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+class OWindowDC;
+
+// Text is measured with the screen dc (as svg) by the backends without the device: recorder, hit test.
+// DC is created by the first measure and kept while the object lives.
+class CScreenMeasure final
+{
+// Construction/Destruction
+public:
+    CScreenMeasure() { }
+    ~CScreenMeasure();
+
+private:
+    CScreenMeasure(const CScreenMeasure &measure);
+
+// Operations
+public:
+    int32_t GetTextHeight(const GDCPaint &paint);
+    GDCSize GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint);
+
+private:
+    GDC &GetGDC();
+
+// Attributes
+private:
+    OWindowDC *m_pDC {nullptr};
+    GDC *m_pGDC {nullptr};
+};
+
+#endif
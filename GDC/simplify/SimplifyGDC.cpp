@@ -0,0 +1,253 @@
+#include "stdafx.h"
+#include "SimplifyGDC.h"
+
+#include "algorithm"
+#include "functional"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+CSimplifyGDC::CSimplifyGDC(CAbsGDC *pDC)
+: m_pDC(pDC)
+{
+
+}
+
+CSimplifyGDC::~CSimplifyGDC()
+{
+    delete m_pDC;
+}
+
+// squared distance from the point to the segment
+static inline double SegmentDistance2(const GDCPoint &pt, const GDCPoint &pt1, const GDCPoint &pt2)
+{
+    const double dx = (double)pt2.x - pt1.x;
+    const double dy = (double)pt2.y - pt1.y;
+    double x = pt1.x;
+    double y = pt1.y;
+    const double dLen2 = dx * dx + dy * dy;
+    if ( dLen2 > 0. ) {
+        double t = ((pt.x - pt1.x) * dx + (pt.y - pt1.y) * dy) / dLen2;
+        t = (std::max)(0., (std::min)(1., t));
+        x += t * dx;
+        y += t * dy;
+    }
+    const double ex = pt.x - x;
+    const double ey = pt.y - y;
+    return ex * ex + ey * ey;
+}
+
+static inline double TriangleArea(const GDCPoint &pt1, const GDCPoint &pt2, const GDCPoint &pt3)
+{
+    return 0.5 * ::fabs(((double)pt2.x - pt1.x) * ((double)pt3.y - pt1.y) - ((double)pt3.x - pt1.x) * ((double)pt2.y - pt1.y));
+}
+
+static inline double Orientation(const GDCPoint &pt1, const GDCPoint &pt2, const GDCPoint &pt)
+{
+    return ((double)pt2.x - pt1.x) * ((double)pt.y - pt1.y) - ((double)pt2.y - pt1.y) * ((double)pt.x - pt1.x);
+}
+
+static inline bool IsInBox(const GDCPoint &pt, const GDCPoint &pt1, const GDCPoint &pt2)
+{
+    return (std::min)(pt1.x, pt2.x) <= pt.x && pt.x <= (std::max)(pt1.x, pt2.x) &&
+           (std::min)(pt1.y, pt2.y) <= pt.y && pt.y <= (std::max)(pt1.y, pt2.y);
+}
+
+// segments cross or touch
+static bool AreSegmentsIntersecting(const GDCPoint &a1, const GDCPoint &a2, const GDCPoint &b1, const GDCPoint &b2)
+{
+    const double d1 = ::Orientation(b1, b2, a1);
+    const double d2 = ::Orientation(b1, b2, a2);
+    const double d3 = ::Orientation(a1, a2, b1);
+    const double d4 = ::Orientation(a1, a2, b2);
+    if ( ((d1 > 0. && d2 < 0.) || (d1 < 0. && d2 > 0.)) && ((d3 > 0. && d4 < 0.) || (d3 < 0. && d4 > 0.)) ) {
+        return true;
+    }
+    return (d1 == 0. && ::IsInBox(a1, b1, b2)) || (d2 == 0. && ::IsInBox(a2, b1, b2)) ||
+           (d3 == 0. && ::IsInBox(b1, a1, a2)) || (d4 == 0. && ::IsInBox(b2, a1, a2));
+}
+
+// marks the kept points of the [nFirst, nLast] chain, ends are marked by the caller
+void CSimplifyGDC::DouglasPeucker(const GDCPoints &points, size_t nFirst, size_t nLast)
+{
+    const double dTolerance2 = m_dTolerance * m_dTolerance;
+    m_stack.clear();
+    m_stack.push_back(nFirst);
+    m_stack.push_back(nLast);
+    while ( !m_stack.empty() ) {
+        const size_t nEnd   = m_stack.back(); m_stack.pop_back();
+        const size_t nBegin = m_stack.back(); m_stack.pop_back();
+
+        const GDCPoint pt1 = points[nBegin];
+        const GDCPoint pt2 = points[nEnd];
+        double dMax = 0.;
+        size_t nMax = nBegin;
+        for (size_t i = nBegin + 1; i < nEnd; ++i) {
+            const double dDist = ::SegmentDistance2(points[i], pt1, pt2);
+            if ( dDist > dMax ) {
+                dMax = dDist;
+                nMax = i;
+            }
+        }
+        if ( dMax > dTolerance2 ) {
+            m_keep[nMax] = 1;
+            m_stack.push_back(nBegin);
+            m_stack.push_back(nMax);
+            m_stack.push_back(nMax);
+            m_stack.push_back(nEnd);
+        }
+    }
+}
+
+// point with the smallest effective area is removed until the area reaches tolerance^2,
+// ring keeps at least 3 points (no collapse), open line keeps its ends
+void CSimplifyGDC::Visvalingam(const GDCPoints &points, size_t nCount, bool bRing)
+{
+    typedef std::pair<double, size_t> CArea;
+
+    const double dMaxArea = m_dTolerance * m_dTolerance;
+    m_prev.resize(nCount);
+    m_next.resize(nCount);
+    m_area.assign(nCount, 0.);
+    m_heap.clear();
+    for (size_t i = 0; i < nCount; ++i) {
+        m_keep[i] = 1;
+        m_prev[i] = (i == 0) ? nCount - 1 : i - 1;
+        m_next[i] = (i + 1 == nCount) ? 0 : i + 1;
+        if ( !bRing && (i == 0 || i + 1 == nCount) ) {
+            continue;
+        }
+        m_area[i] = ::TriangleArea(points[m_prev[i]], points[i], points[m_next[i]]);
+        m_heap.emplace_back(m_area[i], i);
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), std::greater<CArea>());
+
+    size_t nRemaining = nCount;
+    const size_t nMinRemaining = bRing ? 3 : 2;
+    while ( !m_heap.empty() && nRemaining > nMinRemaining ) {
+        std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<CArea>());
+        const CArea area = m_heap.back();
+        m_heap.pop_back();
+        const size_t i = area.second;
+        if ( !m_keep[i] || area.first != m_area[i] ) {
+            continue; // outdated entry
+        }
+        if ( area.first > dMaxArea ) {
+            break;
+        }
+
+        m_keep[i] = 0;
+        --nRemaining;
+        const size_t nPrev = m_prev[i];
+        const size_t nNext = m_next[i];
+        m_next[nPrev] = nNext;
+        m_prev[nNext] = nPrev;
+        for (const size_t j : {nPrev, nNext}) {
+            if ( !bRing && (j == 0 || j + 1 == nCount) ) {
+                continue;
+            }
+            // area never decreases: removed point can not be restored by the later ones
+            m_area[j] = (std::max)(::TriangleArea(points[m_prev[j]], points[j], points[m_next[j]]), area.first);
+            m_heap.emplace_back(m_area[j], j);
+            std::push_heap(m_heap.begin(), m_heap.end(), std::greater<CArea>());
+        }
+    }
+}
+
+// new edges of the simplified ring (they replace the removed points) do not cross the other edges,
+// edges sorted by the left end are swept along x
+bool CSimplifyGDC::IsRingSimple(size_t nCount)
+{
+    const size_t nEdges = m_result.size();
+    auto GetNext  = [nEdges](size_t i) { return i + 1 == nEdges ? 0 : i + 1; };
+    auto GetMinX  = [&](size_t i) { return (std::min)(m_result[i].x, m_result[GetNext(i)].x); };
+    auto GetMaxX  = [&](size_t i) { return (std::max)(m_result[i].x, m_result[GetNext(i)].x); };
+    auto IsNew    = [&](size_t i) { return (m_kept[i] + 1) % nCount != m_kept[GetNext(i)]; };
+    m_edges.clear();
+    for (size_t i = 0; i < nEdges; ++i) {
+        m_edges.push_back(i);
+    }
+    std::sort(m_edges.begin(), m_edges.end(), [&](size_t a, size_t b) { return GetMinX(a) < GetMinX(b); });
+    m_active.clear();
+    for (const size_t i : m_edges) {
+        const int32_t nMinX = GetMinX(i);
+        m_active.erase(std::remove_if(m_active.begin(), m_active.end(), [&](size_t j) { return GetMaxX(j) < nMinX; }), m_active.end());
+        for (const size_t j : m_active) {
+            if ( (!IsNew(i) && !IsNew(j)) || GetNext(i) == j || GetNext(j) == i ) {
+                continue; // both edges are from the input or they share the end point
+            }
+            if ( ::AreSegmentsIntersecting(m_result[i], m_result[GetNext(i)], m_result[j], m_result[GetNext(j)]) ) {
+                return false;
+            }
+        }
+        m_active.push_back(i);
+    }
+    return true;
+}
+
+GDCPoints CSimplifyGDC::Simplify(const GDCPoints &points, bool bRing)
+{
+    if ( m_mode == GDC_SIMPLIFY_NONE || m_dTolerance <= 0. ) {
+        return points;
+    }
+
+    const size_t nSize = points.size();
+    const bool bClosed = bRing && nSize > 1 && points.X(0) == points.X(nSize - 1) && points.Y(0) == points.Y(nSize - 1);
+    const size_t nCount = bClosed ? nSize - 1 : nSize;
+    if ( nCount <= (bRing ? 3u : 2u) ) {
+        return points;
+    }
+
+    GDCPoints source = points;
+    m_keep.assign(nCount + 1, 0);
+    if ( m_mode == GDC_SIMPLIFY_VISVALINGAM ) {
+        Visvalingam(points, nCount, bRing);
+    }
+    else if ( bRing ) {
+        // ring is split at the first and the farthest point: both halves are simplified separately,
+        // the ring can not collapse into the line
+        m_ring.clear();
+        for (size_t i = 0; i < nCount; ++i) {
+            m_ring.emplace_back(points.X(i), points.Y(i));
+        }
+        m_ring.emplace_back(points.X(0), points.Y(0));
+        size_t nFar = 1;
+        double dFar = 0.;
+        for (size_t i = 1; i < nCount; ++i) {
+            const double dx = (double)m_ring[i].x - m_ring[0].x;
+            const double dy = (double)m_ring[i].y - m_ring[0].y;
+            if ( dx * dx + dy * dy > dFar ) {
+                dFar = dx * dx + dy * dy;
+                nFar = i;
+            }
+        }
+        m_keep[0] = m_keep[nFar] = m_keep[nCount] = 1;
+        DouglasPeucker(m_ring, 0, nFar);
+        DouglasPeucker(m_ring, nFar, nCount);
+        source = m_ring;
+    }
+    else {
+        m_keep[0] = m_keep[nCount - 1] = 1;
+        DouglasPeucker(points, 0, nCount - 1);
+    }
+
+    m_result.clear();
+    m_kept.clear();
+    for (size_t i = 0; i < nCount; ++i) {
+        if ( m_keep[i] ) {
+            m_result.emplace_back(source.X(i), source.Y(i));
+            m_kept.push_back(i);
+        }
+    }
+    if ( m_result.size() == nCount || (bRing && m_result.size() < 3) ) {
+        return points;
+    }
+    if ( bRing && !IsRingSimple(nCount) ) { // simplified ring would fill differently
+        return points;
+    }
+    if ( bClosed ) { // first point can be removed by the Visvalingam
+        m_result.push_back(m_result[0]);
+    }
+    return m_result;
+}
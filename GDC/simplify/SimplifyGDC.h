@@ -0,0 +1,173 @@
+#ifndef __SIMPLIFY_GDC_H__
+#define __SIMPLIFY_GDC_H__
+#pragma once
+
+#ifndef __ABS_GDC_H__
+    #include "../AbsGDC.h"
+#endif
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+// Decorator: polylines and polygon rings are simplified to the tolerance (GDC units)
+// before they are passed to the wrapped backend, other calls are forwarded as is.
+class CSimplifyGDC final : public CAbsGDC
+{
+// Construction/Destruction
+public:
+    // pDC is owned
+    CSimplifyGDC(CAbsGDC *pDC);
+    virtual ~CSimplifyGDC();
+
+private:
+    CSimplifyGDC(const CSimplifyGDC &gdc);
+
+// Operations
+public:
+    void SetMode(GDCSimplifyMode mode, double dTolerance) {
+        m_mode       = mode;
+        m_dTolerance = dTolerance;
+    }
+
+// Overrides
+public:
+    virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override {
+        m_pDC->DrawLine(x1, y1, x2, y2, paint);
+    }
+    virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override {
+        m_pDC->DrawPoint(x, y, paint);
+    }
+
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawPolygon(Simplify(points, true), fill_paint, stroke_paint);
+    }
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawPoly(Simplify(points, true), stroke_paint);
+    }
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawPolyLine(Simplify(points, false), stroke_paint);
+    }
+
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override {
+        m_pDC->DrawPolygonTransparent(Simplify(points, true), fill_paint);
+    }
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override {
+        m_pDC->DrawPolygonGradient(Simplify(points, true), paintFrom, paintTo);
+    }
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override {
+        m_pDC->DrawPolygonTexture(points, sTexturePath, dAngle, fZoom);
+    }
+    virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude,
+                                    const wchar_t *sTexturePath, double dAngle, float fZoom) override {
+        m_pDC->DrawPolygonTexture(points, points_exclude, sTexturePath, dAngle, fZoom);
+    }
+
+    virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override {
+        m_pDC->DrawFilledRectangle(x1, y1, x2, y2, fill_paint);
+    }
+    virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override {
+        m_pDC->DrawRectangle(x1, y1, x2, y2, paint);
+    }
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override {
+        m_pDC->DrawLines(points, paint);
+    }
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawRects(corners, stroke_paint);
+    }
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override {
+        m_pDC->DrawPoints(points, paint);
+    }
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override {
+        m_pDC->DrawLineF(x1, y1, x2, y2, paint);
+    }
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawPolyLineF(pPoints, nCount, stroke_paint);
+    }
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override {
+        m_pDC->DrawPolygonF(pPoints, nCount, fill_paint, stroke_paint);
+    }
+    // retained geometry is prepared by the backend once -> not simplified
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override {
+        m_pDC->DrawPath(path, pFillPaint, pStrokePaint);
+    }
+
+    virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override {
+        m_pDC->DrawEllipse(x1, y1, x2, y2, paint);
+    }
+    virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override {
+        m_pDC->DrawFilledEllipse(x1, y1, x2, y2, paint);
+    }
+    virtual void DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint) override {
+        m_pDC->DrawHollowOval(xCenter, yCenter, rx, ry, h, fill_paint);
+    }
+    virtual void DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint) override {
+        m_pDC->DrawArc(x, y, nRadius, fStartAngle, fSweepAngle, paint);
+    }
+
+    virtual void DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y) override {
+        m_pDC->DrawBitmap(hBitmap, x, y);
+    }
+
+    virtual void TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint) override {
+        m_pDC->TextOut(sText, x, y, paint);
+    }
+    virtual void DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint) override {
+        m_pDC->DrawText(sText, rect, paint);
+    }
+    virtual void DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
+                                   const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint) override {
+        m_pDC->DrawTextByEllipse(dCenterAngle, nRadiusX, nRadiusY, xCenter, yCenter, sText, dEllipseAngleRad, paint);
+    }
+    virtual void DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
+                                  bool bRevertTextDir, const GDCPaint &paint) override {
+        m_pDC->DrawTextByCircle(dCenterAngle, nRadius, nCX, nCY, sText, bRevertTextDir, paint);
+    }
+
+    virtual int32_t GetTextHeight(const GDCPaint &paint) const override {
+        return m_pDC->GetTextHeight(paint);
+    }
+    virtual GDCSize GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPaint &paint) const override {
+        return m_pDC->GetTextExtent(sText, nCount, paint);
+    }
+
+    virtual void SetViewportOrg(int32_t x, int32_t y) override { m_pDC->SetViewportOrg(x, y); }
+    virtual GDCPoint GetViewportOrg() const override           { return m_pDC->GetViewportOrg(); }
+
+    virtual void SetCurveTolerance(float fTolerance) override  { m_pDC->SetCurveTolerance(fTolerance); }
+
+    virtual void BeginGroup(const char *sGroupAttributes) override { m_pDC->BeginGroup(sGroupAttributes); }
+    virtual void EndGroup() override                               { m_pDC->EndGroup(); }
+
+    virtual HDC GetHDC() override { return m_pDC->GetHDC(); }
+
+private:
+    // returns points or the simplified copy (valid until the next call)
+    GDCPoints Simplify(const GDCPoints &points, bool bRing);
+    void DouglasPeucker(const GDCPoints &points, size_t nFirst, size_t nLast);
+    void Visvalingam(const GDCPoints &points, size_t nCount, bool bRing);
+    // m_result ring of the nCount input points
+    bool IsRingSimple(size_t nCount);
+
+// Attributes
+private:
+    CAbsGDC *m_pDC;
+    GDCSimplifyMode m_mode {GDC_SIMPLIFY_NONE};
+    double m_dTolerance {0.};
+
+    // scratch buffers are reused between the calls
+    std::vector<GDCPoint> m_ring;  // ring with the closing point
+    std::vector<uint8_t> m_keep;
+    std::vector<size_t> m_stack;
+    std::vector<size_t> m_prev;
+    std::vector<size_t> m_next;
+    std::vector<double> m_area;
+    std::vector<std::pair<double, size_t>> m_heap;
+    std::vector<GDCPoint> m_result;
+    std::vector<size_t> m_kept;   // input index of the m_result points
+    std::vector<size_t> m_edges;  // m_result edges by the left end
+    std::vector<size_t> m_active; // edges crossing the sweep line
+};
+
+#endif
@@ -0,0 +1,78 @@
+#include "stdafx.h"
+#include "SvgAsyncFile.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+CSvgAsyncFile::CSvgAsyncFile(CSvgFileAbs *pFile, size_t nBlockSize, size_t nBlocks)
+: m_pFile(pFile), m_nBlockSize(nBlockSize)
+{
+    ASSERT(nBlocks >= 2);
+    m_current.reserve(m_nBlockSize);
+    for (size_t i1 = 1; i1 < nBlocks; ++i1) {
+        m_free.emplace_back();
+        m_free.back().reserve(m_nBlockSize);
+    }
+    m_thread = std::thread(&CSvgAsyncFile::WriteThread, this);
+}
+
+CSvgAsyncFile::~CSvgAsyncFile()
+{
+    close();
+    delete m_pFile;
+}
+
+void CSvgAsyncFile::Submit()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready.push_back(std::move(m_current));
+    m_cond_ready.notify_one();
+    // backpressure: all blocks are queued -> wait for the writer
+    m_cond_free.wait(lock, [this]() { return !m_free.empty(); });
+    m_current = std::move(m_free.back());
+    m_free.pop_back();
+    m_current.clear();
+}
+
+void CSvgAsyncFile::WriteThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_cond_ready.wait(lock, [this]() { return !m_ready.empty() || m_bClose; });
+        if ( m_ready.empty() ) {
+            break; // closed and everything is written
+        }
+        std::vector<char> block = std::move(m_ready.front());
+        m_ready.pop_front();
+
+        lock.unlock();
+        m_pFile->write(block.data(), block.size());
+        lock.lock();
+
+        m_free.push_back(std::move(block));
+        m_cond_free.notify_one();
+    }
+}
+
+bool CSvgAsyncFile::close()
+{
+    if ( m_bClosed ) {
+        return m_bResult;
+    }
+    m_bClosed = true;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( !m_current.empty() ) {
+            m_ready.push_back(std::move(m_current));
+        }
+        m_bClose = true;
+    }
+    m_cond_ready.notify_one();
+    m_thread.join();
+
+    m_bResult = m_pFile->close();
+    return m_bResult;
+}
@@ -0,0 +1,58 @@
+#ifndef __SVG_ASYNC_FILE_H__
+#define __SVG_ASYNC_FILE_H__
+#pragma once
+
+#ifndef __SVG_FILE_H__
+    #include "SvgFile.h"
+#endif
+
+#include "thread"
+#include "mutex"
+#include "condition_variable"
+#include "deque"
+
+// Double buffered output: drawing thread fills one block while the writer thread passes
+// the previous one to the wrapped file. Block pool is bounded -> producer waits if the writer is behind.
+class CSvgAsyncFile : public CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    // pFile is owned; nBlocks >= 2 (2 -> double buffering)
+    CSvgAsyncFile(CSvgFileAbs *pFile, size_t nBlockSize, size_t nBlocks);
+    virtual ~CSvgAsyncFile();
+
+private:
+    CSvgAsyncFile(const CSvgAsyncFile &file);
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) override {
+        if ( m_current.size() + nSize > m_nBlockSize && !m_current.empty() ) {
+            Submit();
+        }
+        m_current.insert(m_current.end(), sBuffer, sBuffer + nSize);
+    }
+    // waits until the writer thread has passed all blocks to the wrapped file
+    virtual bool close() override;
+
+private:
+    void Submit();
+    void WriteThread();
+
+// Attributes
+private:
+    CSvgFileAbs *m_pFile;
+    size_t m_nBlockSize;
+    std::vector<char> m_current;
+    std::deque<std::vector<char>> m_ready;
+    std::vector<std::vector<char>> m_free;
+    std::mutex m_mutex;
+    std::condition_variable m_cond_ready;
+    std::condition_variable m_cond_free;
+    bool m_bClose  {false};
+    bool m_bClosed {false};
+    bool m_bResult {true};
+    std::thread m_thread;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef __SVG_BOX_H__
+#define __SVG_BOX_H__
+#pragma once
+
+#include "vector"
+#include "algorithm"
+
+// Bounding box of the drawn primitive in the svg user space (stroke included with the pad)
+class CSvgBox final
+{
+// Construction/Destruction
+public:
+    CSvgBox() { }
+    CSvgBox(int32_t x1, int32_t y1, int32_t x2, int32_t y2, int32_t nPad) {
+        Add(x1, y1, nPad);
+        Add(x2, y2, nPad);
+    }
+    template <class TPoints>
+    CSvgBox(const TPoints &points, int32_t nPad) {
+        for (const auto &pt : points) {
+            Add(pt.x, pt.y, nPad);
+        }
+    }
+    ~CSvgBox() { }
+
+// Operations
+public:
+    void Add(int32_t x, int32_t y, int32_t nPad) {
+        m_nMinX = (std::min)(m_nMinX, x - nPad);
+        m_nMinY = (std::min)(m_nMinY, y - nPad);
+        m_nMaxX = (std::max)(m_nMaxX, x + nPad);
+        m_nMaxY = (std::max)(m_nMaxY, y + nPad);
+    }
+    void Add(const CSvgBox &box) {
+        m_nMinX = (std::min)(m_nMinX, box.m_nMinX);
+        m_nMinY = (std::min)(m_nMinY, box.m_nMinY);
+        m_nMaxX = (std::max)(m_nMaxX, box.m_nMaxX);
+        m_nMaxY = (std::max)(m_nMaxY, box.m_nMaxY);
+    }
+    bool IsEmpty() const { return m_nMinX > m_nMaxX; }
+    bool Intersects(const CSvgBox &box) const {
+        return m_nMinX <= box.m_nMaxX && box.m_nMinX <= m_nMaxX &&
+               m_nMinY <= box.m_nMaxY && box.m_nMinY <= m_nMaxY;
+    }
+
+// Attributes
+public:
+    int32_t m_nMinX {INT32_MAX};
+    int32_t m_nMinY {INT32_MAX};
+    int32_t m_nMaxX {INT32_MIN};
+    int32_t m_nMaxY {INT32_MIN};
+};
+
+#endif
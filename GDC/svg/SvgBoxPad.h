@@ -0,0 +1,24 @@
+#ifndef __SVG_BOX_PAD_H__
+#define __SVG_BOX_PAD_H__
+#pragma once
+
+#ifndef __GDC_H__
+    #include "../GDC.h"
+#endif
+
+// Pads of the bounding boxes (CSvgBox culling, CListItem spatial index), shared so both bound the same area
+
+// stroke can be drawn outside of the geometry
+static inline int32_t GetStrokePad(const GDCPaint &paint)
+{
+    return (int32_t)(paint.GetStrokeWidth() * 0.5f) + 1;
+}
+
+// rough bound around the reference point: any alignment and rotation, character is not wider than its height
+static inline int32_t GetTextPad(const wchar_t *sText, const GDCPaint &paint)
+{
+    const int32_t nHeight = paint.GetFontDescr() ? ::abs(paint.GetFontDescr()->m_nHeight) : 0;
+    return nHeight * ((int32_t)(sText ? ::wcslen(sText) : 0) + 1);
+}
+
+#endif
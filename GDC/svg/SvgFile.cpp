@@ -0,0 +1,121 @@
+#include "stdafx.h"
+#include "SvgFile.h"
+
+#include "../GDC.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define SVG_FILE_MIN_BLOCK_SIZE 4096
+#define SVG_CHUNK_SIZE (256 * 1024)
+
+CSvgFile::CSvgFile(const wchar_t *sFilePath, size_t nBlockSize, GDCSvgStats *pStats) 
+: m_pStats(pStats)
+{
+    m_pFile = ::_wfopen(sFilePath, L"wb");
+    ASSERT(m_pFile);
+    if ( !m_pFile ) {
+        m_bError = true;
+        m_pStats->m_bError = true;
+    }
+    else {
+        ::setvbuf(m_pFile, nullptr, _IONBF, 0); // block is already collected -> no double buffering
+    }
+    m_block.resize(nBlockSize < SVG_FILE_MIN_BLOCK_SIZE ? SVG_FILE_MIN_BLOCK_SIZE : nBlockSize);
+
+    #ifdef _DEBUG // currently only for the debug
+    m_sFileName = sFilePath;
+    wchar_t drive[_MAX_DRIVE];
+    wchar_t dir[_MAX_DIR];
+    wchar_t fname[_MAX_FNAME];
+    wchar_t ext[_MAX_EXT];
+    ::_wsplitpath(m_sFileName.c_str(), drive, dir, fname, ext);
+    if ( ::wcscmp(ext, L".html") == 0) {
+        write("<html>", 6);
+    }
+    #endif
+}
+
+CSvgFile::~CSvgFile() 
+{
+    close();
+}
+
+bool CSvgFile::close()
+{
+    if ( !m_pFile ) {
+        return !m_bError;
+    }
+
+    #ifdef _DEBUG // currently only for the debug
+    wchar_t drive[_MAX_DRIVE];
+    wchar_t dir[_MAX_DIR];
+    wchar_t fname[_MAX_FNAME];
+    wchar_t ext[_MAX_EXT];
+    ::_wsplitpath(m_sFileName.c_str(), drive, dir, fname, ext);
+    if ( ::wcscmp(ext, L".html") == 0) {
+        write("</html>", 7);
+    }
+    #endif
+
+    FlushBlock();
+    if ( ::fclose(m_pFile) != 0 ) {
+        m_bError = true;
+    }
+    m_pFile = nullptr;
+    m_pStats->m_bError = m_bError;
+    return !m_bError;
+}
+
+void CSvgFile::FlushBlock()
+{
+    if ( m_nSize == 0 ) {
+        return;
+    }
+    WriteBlock(m_block.data(), m_nSize);
+    m_nSize = 0;
+}
+
+void CSvgFile::WriteBlock(const char *sBuffer, size_t nSize)
+{
+    if ( !m_pFile ) {
+        return;
+    }
+    if ( ::fwrite(sBuffer, 1, nSize, m_pFile) != nSize ) {
+        m_bError = true; // e.g. disk is full
+    }
+    m_pStats->m_nBytes += nSize;
+    ++m_pStats->m_nFlushes;
+}
+
+void CSvgFile::writev(const CSvgChunk *pChunks, size_t nCount)
+{
+    FlushBlock();
+    for (size_t i = 0; i < nCount; ++i) {
+        if ( pChunks[i].m_nSize != 0 ) {
+            WriteBlock(pChunks[i].m_pData, pChunks[i].m_nSize);
+        }
+    }
+}
+
+void CSvgChunkBuffer::write(const char *sBuffer, size_t nSize)
+{
+    if ( m_chunks.empty() || m_chunks.back().size() + nSize > m_chunks.back().capacity() ) {
+        m_chunks.emplace_back();
+        m_chunks.back().reserve(nSize > SVG_CHUNK_SIZE ? nSize : SVG_CHUNK_SIZE);
+    }
+    m_chunks.back().insert(m_chunks.back().end(), sBuffer, sBuffer + nSize);
+}
+
+void CSvgChunkBuffer::WriteTo(CSvgFileAbs *pFile) const
+{
+    std::vector<CSvgChunk> chunks;
+    chunks.reserve(m_chunks.size());
+    for (const std::vector<char> &chunk : m_chunks) {
+        chunks.push_back({chunk.data(), chunk.size()});
+    }
+    if ( !chunks.empty() ) {
+        pFile->writev(chunks.data(), chunks.size());
+    }
+}
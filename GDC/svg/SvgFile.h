@@ -0,0 +1,122 @@
+#ifndef __SVG_FILE_H__
+#define __SVG_FILE_H__
+#pragma once
+
+#include "string"
+#include "vector"
+#include "stdio.h"
+
+class GDCSvgStats;
+
+struct CSvgChunk
+{
+    const char *m_pData;
+    size_t m_nSize;
+};
+
+class CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    CSvgFileAbs() { }
+    virtual ~CSvgFileAbs() { }
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) = 0;
+    // gather write: sinks which can pass the chunks further without copying do override it
+    virtual void writev(const CSvgChunk *pChunks, size_t nCount) {
+        for (size_t i = 0; i < nCount; ++i) {
+            write(pChunks[i].m_pData, pChunks[i].m_nSize);
+        }
+    }
+    // all data is passed to the destination -> false on the write error
+    virtual bool close() { return true; }
+};
+
+// Fragments are collected into the large block, full block goes to the file with the single fwrite:
+// no stream insertion, locale or sentry handling per fragment.
+class CSvgFile : public CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    CSvgFile(const wchar_t *sFilePath, size_t nBlockSize, GDCSvgStats *pStats);
+    virtual ~CSvgFile();
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) override {
+        if ( m_nSize + nSize > m_block.size() ) {
+            FlushBlock();
+            if ( nSize >= m_block.size() ) {
+                WriteBlock(sBuffer, nSize); // does not fit -> goes directly
+                return;
+            }
+        }
+        ::memcpy(m_block.data() + m_nSize, sBuffer, nSize);
+        m_nSize += nSize;
+    }
+    // chunks go to the file directly
+    virtual void writev(const CSvgChunk *pChunks, size_t nCount) override;
+    virtual bool close() override;
+
+private:
+    void FlushBlock();
+    void WriteBlock(const char *sBuffer, size_t nSize);
+
+// Attributes
+private:
+    #ifdef _DEBUG 
+    std::wstring m_sFileName;
+    #endif
+    FILE *m_pFile {nullptr};
+    std::vector<char> m_block;
+    size_t m_nSize {0};
+    bool m_bError {false};
+    GDCSvgStats *m_pStats;
+};
+
+class CSvgBuffer : public CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    CSvgBuffer(std::string *pBuffer) : m_pBuffer(pBuffer) { }
+    ~CSvgBuffer() { }
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) override {
+        m_pBuffer->append(sBuffer, nSize);
+    }
+
+// Attributes
+private:
+    std::string *m_pBuffer;
+};
+
+// Keeps the data in memory as the list of the large chunks (no reallocation of the collected data),
+// chunks are passed to the other sink by the single gather write.
+class CSvgChunkBuffer : public CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    CSvgChunkBuffer() { }
+    ~CSvgChunkBuffer() { }
+
+private:
+    CSvgChunkBuffer(const CSvgChunkBuffer &buffer);
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) override;
+
+// Operations
+public:
+    void WriteTo(CSvgFileAbs *pFile) const;
+
+// Attributes
+private:
+    std::vector<std::vector<char>> m_chunks; // capacity of the chunk is reserved once
+};
+
+#endif
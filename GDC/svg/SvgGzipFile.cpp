@@ -0,0 +1,529 @@
+#include "stdafx.h"
+#include "SvgGzipFile.h"
+
+#include "queue"
+#include "algorithm"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+#define DEFLATE_WSIZE       32768
+#define DEFLATE_WMASK       (DEFLATE_WSIZE - 1)
+#define DEFLATE_HASH_BITS   15
+#define DEFLATE_HASH_SIZE   (1 << DEFLATE_HASH_BITS)
+#define DEFLATE_MIN_MATCH   3
+#define DEFLATE_MAX_MATCH   258
+#define DEFLATE_BLOCK_SIZE  65536
+#define DEFLATE_MAX_STORED  65535
+
+namespace deflate_internal
+{
+    static const uint16_t kLenBase[29]   = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t  kLenExtra[29]  = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t kDistBase[30]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+                                             4097, 6145, 8193, 12289, 16385, 24577 };
+    static const uint8_t  kDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    // order of the code length code lengths in the dynamic block header
+    static const uint8_t  kClOrder[19]   = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    // level -> max hash chain length, nice match length
+    static const int32_t kMaxChain[10]   = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+    static const int32_t kNiceLength[10] = { 0, 8, 16, 32, 64, 128, 128, 258, 258, 258 };
+
+    class CTables
+    {
+    public:
+        CTables()
+        {
+            for (int32_t nCode = 0; nCode < 29; ++nCode) {
+                const int32_t nLast = (nCode == 28) ? 258 : kLenBase[nCode] + (1 << kLenExtra[nCode]) - 1;
+                for (int32_t nLen = kLenBase[nCode]; nLen <= nLast; ++nLen) {
+                    m_len_code[nLen] = (uint8_t)nCode;
+                }
+            }
+            m_len_code[258] = 28; // 227 + 31 would be 258 too, fixed code 285 is preferred
+            for (int32_t nCode = 0; nCode < 30; ++nCode) {
+                const int32_t nLast = kDistBase[nCode] + (1 << kDistExtra[nCode]) - 1;
+                for (int32_t nDist = kDistBase[nCode]; nDist <= nLast; ++nDist) {
+                    m_dist_code[nDist] = (uint8_t)nCode;
+                }
+            }
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int32_t k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                m_crc[n] = c;
+            }
+        }
+
+    public:
+        uint8_t  m_len_code[DEFLATE_MAX_MATCH + 1];
+        uint8_t  m_dist_code[DEFLATE_WSIZE + 1];
+        uint32_t m_crc[256];
+    };
+
+    static const CTables &GetTables()
+    {
+        static const CTables tables;
+        return tables;
+    }
+
+    static inline uint16_t ReverseBits(uint16_t nCode, int32_t nLen)
+    {
+        uint16_t nResult = 0;
+        for (int32_t i1 = 0; i1 < nLen; ++i1) {
+            nResult = (uint16_t)((nResult << 1) | (nCode & 1));
+            nCode >>= 1;
+        }
+        return nResult;
+    }
+
+    // Huffman code lengths limited to nMaxBits: frequencies are flattened until the tree fits
+    static void BuildLengths(const uint32_t *pFreqs, int32_t nCount, int32_t nMaxBits, uint8_t *pLengths)
+    {
+        std::vector<uint32_t> freqs(pFreqs, pFreqs + nCount);
+
+        // at least two codes -> complete code, single used symbol would not be decodable
+        int32_t nUsed = 0;
+        for (uint32_t nFreq : freqs) {
+            if ( nFreq ) {
+                ++nUsed;
+            }
+        }
+        for (int32_t i1 = 0; nUsed < 2 && i1 < nCount; ++i1) {
+            if ( !freqs[i1] ) {
+                freqs[i1] = 1;
+                ++nUsed;
+            }
+        }
+
+        struct CNode
+        {
+            uint32_t m_nFreq;
+            int32_t  m_nLeft;
+            int32_t  m_nRight;
+            int32_t  m_nSymbol;
+        };
+        typedef std::pair<uint32_t, int32_t> CQueueItem; // freq, node
+        std::vector<CNode> nodes;
+        std::vector<int32_t> depth;
+
+        for (;;)
+        {
+            nodes.clear();
+            std::priority_queue<CQueueItem, std::vector<CQueueItem>, std::greater<CQueueItem>> queue;
+            for (int32_t i1 = 0; i1 < nCount; ++i1) {
+                if ( freqs[i1] ) {
+                    queue.push(CQueueItem(freqs[i1], (int32_t)nodes.size()));
+                    nodes.push_back({freqs[i1], -1, -1, i1});
+                }
+            }
+            while ( queue.size() > 1 ) {
+                const CQueueItem left  = queue.top(); queue.pop();
+                const CQueueItem right = queue.top(); queue.pop();
+                queue.push(CQueueItem(left.first + right.first, (int32_t)nodes.size()));
+                nodes.push_back({left.first + right.first, left.second, right.second, -1});
+            }
+
+            // children are always created before the parent -> top-down in the reverse order
+            depth.assign(nodes.size(), 0);
+            int32_t nMaxDepth = 0;
+            for (int32_t i1 = (int32_t)nodes.size() - 1; i1 >= 0; --i1) {
+                const CNode &node = nodes[i1];
+                if ( node.m_nSymbol >= 0 ) {
+                    nMaxDepth = std::max(nMaxDepth, depth[i1]);
+                    continue;
+                }
+                depth[node.m_nLeft]  = depth[i1] + 1;
+                depth[node.m_nRight] = depth[i1] + 1;
+            }
+            if ( nMaxDepth <= nMaxBits ) {
+                break;
+            }
+            for (uint32_t &nFreq : freqs) {
+                if ( nFreq ) {
+                    nFreq = (nFreq >> 1) | 1;
+                }
+            }
+        }
+
+        ::memset(pLengths, 0, nCount);
+        for (size_t i1 = 0; i1 < nodes.size(); ++i1) {
+            if ( nodes[i1].m_nSymbol >= 0 ) {
+                pLengths[nodes[i1].m_nSymbol] = (uint8_t)depth[i1];
+            }
+        }
+    }
+
+    // canonical codes, bit reversed -> deflate bit stream is LSB first
+    static void BuildCodes(const uint8_t *pLengths, int32_t nCount, uint16_t *pCodes)
+    {
+        uint16_t bl_count[16]  = {0};
+        uint16_t next_code[16] = {0};
+        for (int32_t i1 = 0; i1 < nCount; ++i1) {
+            ++bl_count[pLengths[i1]];
+        }
+        bl_count[0] = 0;
+        uint16_t nCode = 0;
+        for (int32_t nBits = 1; nBits < 16; ++nBits) {
+            nCode = (uint16_t)((nCode + bl_count[nBits - 1]) << 1);
+            next_code[nBits] = nCode;
+        }
+        for (int32_t i1 = 0; i1 < nCount; ++i1) {
+            const int32_t nLen = pLengths[i1];
+            pCodes[i1] = nLen ? ReverseBits(next_code[nLen]++, nLen) : 0;
+        }
+    }
+};
+
+CSvgGzipFile::CSvgGzipFile(CSvgFileAbs *pFile, int32_t nLevel)
+: m_pFile(pFile)
+{
+    m_nLevel      = std::min(std::max(nLevel, 0), 9);
+    m_nMaxChain   = deflate_internal::kMaxChain[m_nLevel];
+    m_nNiceLength = deflate_internal::kNiceLength[m_nLevel];
+
+    m_window.reserve(2 * DEFLATE_WSIZE + DEFLATE_BLOCK_SIZE);
+    if ( m_nLevel > 0 ) {
+        m_head.assign(DEFLATE_HASH_SIZE, -1);
+        m_prev.assign(DEFLATE_WSIZE, -1);
+        m_tokens.reserve(DEFLATE_BLOCK_SIZE);
+    }
+    m_nCrc = 0xFFFFFFFFu;
+
+    // gzip member header: ID1 ID2 CM(deflate) FLG MTIME(4) XFL OS(unknown)
+    static const uint8_t header[10] = { 0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF };
+    m_out.insert(m_out.end(), header, header + sizeof(header));
+}
+
+CSvgGzipFile::~CSvgGzipFile()
+{
+    close();
+    delete m_pFile;
+}
+
+void CSvgGzipFile::write(const char *sBuffer, size_t nSize)
+{
+    const uint32_t *crc_table = deflate_internal::GetTables().m_crc;
+    const uint8_t *pData = (const uint8_t *)sBuffer;
+    uint32_t nCrc = m_nCrc;
+    for (size_t i1 = 0; i1 < nSize; ++i1) {
+        nCrc = crc_table[(nCrc ^ pData[i1]) & 0xFF] ^ (nCrc >> 8);
+    }
+    m_nCrc   = nCrc;
+    m_nSize += (uint32_t)nSize;
+
+    // window never keeps more than history + one block
+    while ( nSize > 0 ) {
+        const size_t nPending = m_window.size() - m_nPos;
+        const size_t nTake    = std::min(nSize, DEFLATE_BLOCK_SIZE - nPending);
+        m_window.insert(m_window.end(), pData, pData + nTake);
+        pData += nTake;
+        nSize -= nTake;
+        if ( m_window.size() - m_nPos >= DEFLATE_BLOCK_SIZE ) {
+            CompressBlock(m_window.size(), false);
+        }
+    }
+}
+
+bool CSvgGzipFile::close()
+{
+    if ( m_bClosed ) {
+        return m_bResult;
+    }
+    m_bClosed = true;
+
+    CompressBlock(m_window.size(), true);
+    AlignToByte();
+
+    const uint32_t nCrc = m_nCrc ^ 0xFFFFFFFFu;
+    for (int32_t i1 = 0; i1 < 4; ++i1) {
+        m_out.push_back((uint8_t)(nCrc >> (8 * i1)));
+    }
+    for (int32_t i1 = 0; i1 < 4; ++i1) {
+        m_out.push_back((uint8_t)(m_nSize >> (8 * i1)));
+    }
+    FlushOutput();
+
+    m_bResult = m_pFile->close();
+    return m_bResult;
+}
+
+void CSvgGzipFile::CompressBlock(size_t nEnd, bool bFinal)
+{
+    if ( m_nLevel == 0 ) {
+        WriteStoredBlock(m_nPos, nEnd, bFinal);
+        m_nPos = nEnd;
+    }
+    else {
+        FindMatches(nEnd);
+        WriteHuffmanBlock(bFinal);
+    }
+    SlideWindow();
+    FlushOutput();
+}
+
+void CSvgGzipFile::WriteStoredBlock(size_t nBegin, size_t nEnd, bool bFinal)
+{
+    do
+    {
+        const size_t nLen = std::min(nEnd - nBegin, (size_t)DEFLATE_MAX_STORED);
+        const bool bLast = bFinal && nBegin + nLen == nEnd;
+        PutBits(bLast ? 1 : 0, 1);
+        PutBits(0, 2); // BTYPE 00 - no compression
+        AlignToByte();
+        m_out.push_back((uint8_t)nLen);
+        m_out.push_back((uint8_t)(nLen >> 8));
+        m_out.push_back((uint8_t)~nLen);
+        m_out.push_back((uint8_t)(~nLen >> 8));
+        m_out.insert(m_out.end(), m_window.begin() + nBegin, m_window.begin() + nBegin + nLen);
+        nBegin += nLen;
+    }
+    while ( nBegin < nEnd );
+}
+
+static inline uint32_t DeflateHash(const uint8_t *pData)
+{
+    return ((pData[0] << 10) ^ (pData[1] << 5) ^ pData[2]) & (DEFLATE_HASH_SIZE - 1);
+}
+
+// greedy LZ77 over the hash chains, matches may reach into the not yet compressed data
+void CSvgGzipFile::FindMatches(size_t nEnd)
+{
+    m_tokens.clear();
+
+    const uint8_t *pWindow = m_window.data();
+    const size_t nSize = m_window.size();
+    size_t nPos = m_nPos;
+    while ( nPos < nEnd )
+    {
+        const size_t nLimit = std::min(nSize - nPos, (size_t)DEFLATE_MAX_MATCH);
+        size_t nBestLen  = 0;
+        size_t nBestDist = 0;
+        if ( nLimit >= DEFLATE_MIN_MATCH )
+        {
+            const uint32_t nHash = DeflateHash(pWindow + nPos);
+            int32_t nCandidate = m_head[nHash];
+            int32_t nChain = m_nMaxChain;
+            while ( nCandidate >= 0 && nChain-- > 0 )
+            {
+                const size_t nDist = nPos - nCandidate;
+                if ( nDist > DEFLATE_WSIZE ) {
+                    break;
+                }
+                const uint8_t *pCandidate = pWindow + nCandidate;
+                const uint8_t *pCurrent   = pWindow + nPos;
+                if ( pCandidate[nBestLen] == pCurrent[nBestLen] ) {
+                    size_t nLen = 0;
+                    while ( nLen < nLimit && pCandidate[nLen] == pCurrent[nLen] ) {
+                        ++nLen;
+                    }
+                    if ( nLen > nBestLen ) {
+                        nBestLen  = nLen;
+                        nBestDist = nDist;
+                        if ( (int32_t)nLen >= m_nNiceLength || nLen == nLimit ) {
+                            break;
+                        }
+                    }
+                }
+                const int32_t nNext = m_prev[nCandidate & DEFLATE_WMASK];
+                if ( nNext >= nCandidate ) {
+                    break; // slot is reused by the newer position
+                }
+                nCandidate = nNext;
+            }
+            m_prev[nPos & DEFLATE_WMASK] = m_head[nHash];
+            m_head[nHash] = (int32_t)nPos;
+        }
+
+        if ( nBestLen >= DEFLATE_MIN_MATCH ) {
+            m_tokens.push_back({(uint16_t)nBestLen, (uint16_t)nBestDist});
+            for (size_t i1 = 1; i1 < nBestLen; ++i1) {
+                const size_t nInsert = nPos + i1;
+                if ( nInsert + DEFLATE_MIN_MATCH > nSize ) {
+                    break;
+                }
+                const uint32_t nHash = DeflateHash(pWindow + nInsert);
+                m_prev[nInsert & DEFLATE_WMASK] = m_head[nHash];
+                m_head[nHash] = (int32_t)nInsert;
+            }
+            nPos += nBestLen;
+        }
+        else {
+            m_tokens.push_back({pWindow[nPos], 0});
+            ++nPos;
+        }
+    }
+    m_nPos = nPos;
+}
+
+void CSvgGzipFile::WriteHuffmanBlock(bool bFinal)
+{
+    const deflate_internal::CTables &tables = deflate_internal::GetTables();
+
+    uint32_t freq_ll[286] = {0};
+    uint32_t freq_d[30]   = {0};
+    for (const CToken &token : m_tokens) {
+        if ( token.m_nDist == 0 ) {
+            ++freq_ll[token.m_nLitLen];
+        }
+        else {
+            ++freq_ll[257 + tables.m_len_code[token.m_nLitLen]];
+            ++freq_d[tables.m_dist_code[token.m_nDist]];
+        }
+    }
+    freq_ll[256] = 1; // end of block
+
+    uint8_t  len_ll[286];
+    uint8_t  len_d[30];
+    uint16_t code_ll[286];
+    uint16_t code_d[30];
+    deflate_internal::BuildLengths(freq_ll, 286, 15, len_ll);
+    deflate_internal::BuildLengths(freq_d,  30,  15, len_d);
+    deflate_internal::BuildCodes(len_ll, 286, code_ll);
+    deflate_internal::BuildCodes(len_d,  30,  code_d);
+
+    int32_t nLitCount = 286;
+    while ( nLitCount > 257 && len_ll[nLitCount - 1] == 0 ) {
+        --nLitCount;
+    }
+    int32_t nDistCount = 30;
+    while ( nDistCount > 1 && len_d[nDistCount - 1] == 0 ) {
+        --nDistCount;
+    }
+
+    // run length encoded code lengths: 16 - repeat previous 3..6, 17 - zeros 3..10, 18 - zeros 11..138
+    uint8_t lengths[286 + 30];
+    ::memcpy(lengths, len_ll, nLitCount);
+    ::memcpy(lengths + nLitCount, len_d, nDistCount);
+    const int32_t nLengths = nLitCount + nDistCount;
+
+    std::vector<std::pair<uint8_t, uint8_t>> rle; // symbol, extra bits value
+    rle.reserve(nLengths);
+    int32_t i1 = 0;
+    while ( i1 < nLengths )
+    {
+        const uint8_t nLen = lengths[i1];
+        int32_t nRun = 1;
+        while ( i1 + nRun < nLengths && lengths[i1 + nRun] == nLen ) {
+            ++nRun;
+        }
+        i1 += nRun;
+        if ( nLen == 0 ) {
+            while ( nRun >= 11 ) {
+                const int32_t nRepeat = std::min(nRun, 138);
+                rle.push_back(std::make_pair((uint8_t)18, (uint8_t)(nRepeat - 11)));
+                nRun -= nRepeat;
+            }
+            if ( nRun >= 3 ) {
+                rle.push_back(std::make_pair((uint8_t)17, (uint8_t)(nRun - 3)));
+                nRun = 0;
+            }
+        }
+        else {
+            rle.push_back(std::make_pair(nLen, (uint8_t)0));
+            --nRun;
+            while ( nRun >= 3 ) {
+                const int32_t nRepeat = std::min(nRun, 6);
+                rle.push_back(std::make_pair((uint8_t)16, (uint8_t)(nRepeat - 3)));
+                nRun -= nRepeat;
+            }
+        }
+        for (; nRun > 0; --nRun) {
+            rle.push_back(std::make_pair(nLen, (uint8_t)0));
+        }
+    }
+
+    uint32_t freq_cl[19] = {0};
+    for (const auto &item : rle) {
+        ++freq_cl[item.first];
+    }
+    uint8_t  len_cl[19];
+    uint16_t code_cl[19];
+    deflate_internal::BuildLengths(freq_cl, 19, 7, len_cl);
+    deflate_internal::BuildCodes(len_cl, 19, code_cl);
+    int32_t nClCount = 19;
+    while ( nClCount > 4 && len_cl[deflate_internal::kClOrder[nClCount - 1]] == 0 ) {
+        --nClCount;
+    }
+
+    PutBits(bFinal ? 1 : 0, 1);
+    PutBits(2, 2); // BTYPE 10 - dynamic Huffman codes
+    PutBits(nLitCount - 257, 5);
+    PutBits(nDistCount - 1, 5);
+    PutBits(nClCount - 4, 4);
+    for (int32_t i2 = 0; i2 < nClCount; ++i2) {
+        PutBits(len_cl[deflate_internal::kClOrder[i2]], 3);
+    }
+    for (const auto &item : rle) {
+        PutBits(code_cl[item.first], len_cl[item.first]);
+        switch (item.first)
+        {
+        case 16: PutBits(item.second, 2); break;
+        case 17: PutBits(item.second, 3); break;
+        case 18: PutBits(item.second, 7); break;
+        default: break;
+        }
+    }
+
+    for (const CToken &token : m_tokens)
+    {
+        if ( token.m_nDist == 0 ) {
+            PutBits(code_ll[token.m_nLitLen], len_ll[token.m_nLitLen]);
+            continue;
+        }
+        const int32_t nLenCode = tables.m_len_code[token.m_nLitLen];
+        PutBits(code_ll[257 + nLenCode], len_ll[257 + nLenCode]);
+        if ( deflate_internal::kLenExtra[nLenCode] ) {
+            PutBits(token.m_nLitLen - deflate_internal::kLenBase[nLenCode], deflate_internal::kLenExtra[nLenCode]);
+        }
+        const int32_t nDistCode = tables.m_dist_code[token.m_nDist];
+        PutBits(code_d[nDistCode], len_d[nDistCode]);
+        if ( deflate_internal::kDistExtra[nDistCode] ) {
+            PutBits(token.m_nDist - deflate_internal::kDistBase[nDistCode], deflate_internal::kDistExtra[nDistCode]);
+        }
+    }
+    PutBits(code_ll[256], len_ll[256]);
+}
+
+// keeps at least the last 32KB of the history,
+// shift is a multiple of the window size -> m_prev slots (position & mask) stay valid
+void CSvgGzipFile::SlideWindow()
+{
+    if ( m_nPos < 2 * DEFLATE_WSIZE ) {
+        return;
+    }
+    const size_t nShift = (m_nPos / DEFLATE_WSIZE - 1) * DEFLATE_WSIZE;
+    m_window.erase(m_window.begin(), m_window.begin() + nShift);
+    m_nPos -= nShift;
+    if ( m_nLevel == 0 ) {
+        return;
+    }
+    const int32_t nShift32 = (int32_t)nShift;
+    for (int32_t &nPos : m_head) {
+        nPos = (nPos >= nShift32) ? nPos - nShift32 : -1;
+    }
+    for (int32_t &nPos : m_prev) {
+        nPos = (nPos >= nShift32) ? nPos - nShift32 : -1;
+    }
+}
+
+void CSvgGzipFile::AlignToByte()
+{
+    if ( m_nBitCount > 0 ) {
+        m_out.push_back((uint8_t)m_nBitBuffer);
+    }
+    m_nBitBuffer = 0;
+    m_nBitCount  = 0;
+}
+
+void CSvgGzipFile::FlushOutput()
+{
+    if ( m_out.empty() ) {
+        return;
+    }
+    m_pFile->write((const char *)m_out.data(), m_out.size());
+    m_out.clear();
+}
@@ -0,0 +1,75 @@
+#ifndef __SVG_GZIP_FILE_H__
+#define __SVG_GZIP_FILE_H__
+#pragma once
+
+#ifndef __SVG_FILE_H__
+    #include "SvgFile.h"
+#endif
+
+// Streaming gzip (RFC 1951/1952) output: data is compressed block by block while SvgGDC writes,
+// compressed blocks are passed to the wrapped file. No external zlib dependency.
+class CSvgGzipFile : public CSvgFileAbs
+{
+// Construction/Desctruction
+public:
+    // pFile is owned; nLevel: 0 (stored, no compression) .. 9 (best compression)
+    CSvgGzipFile(CSvgFileAbs *pFile, int32_t nLevel);
+    virtual ~CSvgGzipFile();
+
+private:
+    CSvgGzipFile(const CSvgGzipFile &file);
+
+// Overrides
+public:
+    virtual void write(const char *sBuffer, size_t nSize) override;
+    // final block and gzip trailer
+    virtual bool close() override;
+
+private:
+    void CompressBlock(size_t nEnd, bool bFinal);
+    void WriteStoredBlock(size_t nBegin, size_t nEnd, bool bFinal);
+    void WriteHuffmanBlock(bool bFinal);
+    void FindMatches(size_t nEnd);
+    void SlideWindow();
+    void PutBits(uint32_t nBits, int32_t nCount) {
+        m_nBitBuffer |= (uint64_t)nBits << m_nBitCount;
+        m_nBitCount  += nCount;
+        while ( m_nBitCount >= 8 ) {
+            m_out.push_back((uint8_t)m_nBitBuffer);
+            m_nBitBuffer >>= 8;
+            m_nBitCount  -= 8;
+        }
+    }
+    void AlignToByte();
+    void FlushOutput();
+
+// Attributes
+private:
+    struct CToken
+    {
+        uint16_t m_nLitLen; // literal or match length
+        uint16_t m_nDist;   // 0 -> literal
+    };
+
+    CSvgFileAbs *m_pFile;
+    int32_t m_nLevel;
+    int32_t m_nMaxChain;
+    int32_t m_nNiceLength;
+    bool m_bClosed {false};
+    bool m_bResult {true};
+
+    std::vector<uint8_t> m_window; // history (up to 32KB) + not compressed input
+    size_t m_nPos {0};             // m_window[m_nPos..] not compressed yet
+    std::vector<int32_t> m_head;   // hash -> last position in the window
+    std::vector<int32_t> m_prev;   // position & mask -> previous position with the same hash
+    std::vector<CToken> m_tokens;
+
+    std::vector<uint8_t> m_out;
+    uint64_t m_nBitBuffer {0};
+    int32_t  m_nBitCount  {0};
+
+    uint32_t m_nCrc  {0};
+    uint32_t m_nSize {0}; // input size modulo 2^32
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef __SVG_PATH_H__
+#define __SVG_PATH_H__
+#pragma once
+
+#ifndef __ABS_PATH_H__
+    #include "../AbsPath.h"
+#endif
+
+#ifndef __SVG_BOX_H__
+    #include "SvgBox.h"
+#endif
+
+#include "string"
+
+// GDCPath prepared by the SvgGDC: encoded d="..." value and the box without the stroke pad
+class CSvgPath final : public CAbsPath
+{
+// Construction/Destruction
+public:
+    CSvgPath() { }
+    virtual ~CSvgPath() { }
+
+// Attributes
+public:
+    std::string m_sData;
+    CSvgBox m_box;
+};
+
+#endif
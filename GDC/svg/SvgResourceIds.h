@@ -0,0 +1,82 @@
+#ifndef __SVG_RESOURCE_IDS_H__
+#define __SVG_RESOURCE_IDS_H__
+#pragma once
+
+#include "vector"
+#include "string"
+
+// Packed integer key -> resource id (pattern, gradient), open addressing with linear probing.
+// Lookup does not allocate, id string is created only once for the new key.
+class CSvgResourceIds final
+{
+// Construction/Destruction
+public:
+    CSvgResourceIds() { m_slots.resize(64); }
+    ~CSvgResourceIds() { }
+
+private:
+    CSvgResourceIds(const CSvgResourceIds &ids);
+
+// Operations
+public:
+    // nullptr -> not found, pointer is valid until the next Add
+    const std::string *Find(uint64_t nKey) const {
+        const CSlot &slot = m_slots[FindSlot(nKey)];
+        return slot.m_nKey == nKey ? &m_ids[slot.m_nIndex] : nullptr;
+    }
+    // key must be new
+    const std::string &Add(uint64_t nKey, std::string &&sId) {
+        ASSERT(nKey != EMPTY_KEY);
+        if ( (m_ids.size() + 1) * 2 > m_slots.size() ) {
+            Rehash(m_slots.size() * 2);
+        }
+        CSlot &slot = m_slots[FindSlot(nKey)];
+        ASSERT(slot.m_nKey == EMPTY_KEY);
+        slot.m_nKey   = nKey;
+        slot.m_nIndex = (uint32_t)m_ids.size();
+        m_ids.push_back(std::move(sId));
+        return m_ids.back();
+    }
+    size_t Size() const { return m_ids.size(); }
+
+private:
+    static uint64_t Hash(uint64_t nKey) {
+        nKey ^= nKey >> 33;
+        nKey *= 0xff51afd7ed558ccdULL;
+        nKey ^= nKey >> 33;
+        return nKey;
+    }
+    size_t FindSlot(uint64_t nKey) const {
+        const size_t nMask = m_slots.size() - 1;
+        size_t nSlot = (size_t)Hash(nKey) & nMask;
+        while ( m_slots[nSlot].m_nKey != EMPTY_KEY && m_slots[nSlot].m_nKey != nKey ) {
+            nSlot = (nSlot + 1) & nMask;
+        }
+        return nSlot;
+    }
+    void Rehash(size_t nSize) {
+        std::vector<CSlot> slots(nSize);
+        m_slots.swap(slots);
+        for (const CSlot &slot : slots) {
+            if ( slot.m_nKey != EMPTY_KEY ) {
+                m_slots[FindSlot(slot.m_nKey)] = slot;
+            }
+        }
+    }
+
+// Attributes
+public:
+    // COLORREF uses 24 bits -> packed keys never have all bits set
+    static const uint64_t EMPTY_KEY = ~0ULL;
+
+private:
+    struct CSlot
+    {
+        uint64_t m_nKey   {EMPTY_KEY};
+        uint32_t m_nIndex {0};
+    };
+    std::vector<CSlot> m_slots;      // size is power of 2
+    std::vector<std::string> m_ids;  // id strings in the creation order
+};
+
+#endif
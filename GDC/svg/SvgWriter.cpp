@@ -0,0 +1,50 @@
+#include "stdafx.h"
+#include "SvgWriter.h"
+
+#include "SvgFile.h"
+
+#ifdef _DEBUG
+    #define new DEBUG_NEW
+#endif
+
+CSvgWriter::CSvgWriter(CSvgFileAbs *pFile)
+: m_pFile(pFile)
+{
+    m_buffer.resize(4096);
+}
+
+void CSvgWriter::Grow(size_t nRequired)
+{
+    size_t nSize = m_buffer.size() * 2;
+    if ( nSize < nRequired ) {
+        nSize = nRequired;
+    }
+    m_buffer.resize(nSize);
+}
+
+// or maybe should be used:
+// http://stackoverflow.com/questions/4358870/convert-wstring-to-string-encoded-in-utf-8
+// std::wstring_convert<std::codecvt_utf8<wchar_t>> myconv;
+// return myconv.to_bytes(str);
+void CSvgWriter::AppendUTF8(const wchar_t *sText)
+{
+    const int32_t nLen = (int32_t)::wcslen(sText);
+    if ( nLen <= 0  ) {
+        return;
+    }
+
+    // UTF-16 unit takes at most 3 bytes in the UTF-8 (surrogate pair: 2 units -> 4 bytes)
+    const int32_t nMaxSize = nLen * 3;
+    Reserve(nMaxSize);
+    const int32_t nSize = ::WideCharToMultiByte(CP_UTF8, 0, sText, nLen, m_buffer.data() + m_nSize, nMaxSize, NULL, NULL);
+    m_nSize += nSize;
+}
+
+void CSvgWriter::Flush()
+{
+    if ( m_nSize == 0 ) {
+        return;
+    }
+    m_pFile->write(m_buffer.data(), m_nSize);
+    m_nSize = 0;
+}
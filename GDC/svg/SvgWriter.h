@@ -0,0 +1,155 @@
+#ifndef __SVG_WRITER_H__
+#define __SVG_WRITER_H__
+#pragma once
+
+#include "vector"
+#include "charconv"
+#include "algorithm"
+#include "math.h"
+
+class CSvgFileAbs;
+
+// Element/attribute builder: numbers are formatted with std::to_chars straight into
+// the one reusable per-document buffer, the finished element goes to the sink with a single write.
+class CSvgWriter final
+{
+// Construction/Destruction
+public:
+    CSvgWriter(CSvgFileAbs *pFile);
+    ~CSvgWriter() { }
+
+private:
+    CSvgWriter(const CSvgWriter &writer);
+
+// Operations
+public:
+    // <sTag
+    void BeginElem(const char *sTag) {
+        Append('<');
+        Append(sTag);
+    }
+    // />\n -> element is passed to the sink
+    void EndElem() {
+        Append("/>\n", 3);
+        Flush();
+    }
+    // ></sTag>\n -> element with the content is passed to the sink
+    void CloseElem(const char *sTag) {
+        Append("</", 2);
+        Append(sTag);
+        Append(">\n", 2);
+        Flush();
+    }
+    // raw text line
+    void Line(const char *sValue) {
+        Append(sValue);
+        Append('\n');
+        Flush();
+    }
+
+    //  sName="
+    void BeginAttr(const char *sName) {
+        Append(' ');
+        Append(sName);
+        Append("=\"", 2);
+    }
+    void EndAttr() { Append('"'); }
+
+    template <class TValue>
+    void Attr(const char *sName, TValue value) {
+        BeginAttr(sName);
+        Append(value);
+        EndAttr();
+    }
+
+    void Append(char ch) {
+        Reserve(1);
+        m_buffer[m_nSize++] = ch;
+    }
+    void Append(const char *sValue) {
+        Append(sValue, ::strlen(sValue));
+    }
+    void Append(const char *sValue, size_t nLen) {
+        Reserve(nLen);
+        ::memcpy(m_buffer.data() + m_nSize, sValue, nLen);
+        m_nSize += nLen;
+    }
+    void Append(int32_t nValue) {
+        Reserve(11);
+        char *pBuffer = m_buffer.data() + m_nSize;
+        m_nSize = std::to_chars(pBuffer, pBuffer + 11, nValue).ptr - m_buffer.data();
+    }
+    // printf("%.6g") equivalent: floats have at most 6 reliable significant digits
+    // e.g: 0.85 -> results: 0.85000002 with the %.8g vs2017
+    void Append(float fValue) {
+        Reserve(15); // -1.2345678e-005
+        char *pBuffer = m_buffer.data() + m_nSize;
+        m_nSize = std::to_chars(pBuffer, pBuffer + 15, fValue, std::chars_format::general, 6).ptr - m_buffer.data();
+    }
+    // x,y
+    void AppendPoint(int32_t x, int32_t y) {
+        Append(x);
+        Append(',');
+        Append(y);
+    }
+    // sub-pixel coordinate: 1/100 precision, trailing zeros are dropped (12, 12.5, -0.25)
+    void AppendFixed(float fValue) {
+        const double dValue = (std::max)(-2147483648., (std::min)(2147483647., (double)fValue));
+        int64_t nValue = ::llround(dValue * 100.);
+        if ( nValue < 0 ) {
+            Append('-');
+            nValue = -nValue;
+        }
+        Reserve(13);
+        char *pBuffer = m_buffer.data() + m_nSize;
+        m_nSize = std::to_chars(pBuffer, pBuffer + 13, nValue / 100).ptr - m_buffer.data();
+        const int32_t nFraction = (int32_t)(nValue % 100);
+        if ( nFraction != 0 ) {
+            Append('.');
+            Append((char)('0' + nFraction / 10));
+            if ( nFraction % 10 != 0 ) {
+                Append((char)('0' + nFraction % 10));
+            }
+        }
+    }
+    void AppendPointF(float x, float y) {
+        AppendFixed(x);
+        Append(',');
+        AppendFixed(y);
+    }
+    void AppendUTF8(const wchar_t *sText); // platform specific
+
+    const char *Data() const { return m_buffer.data(); }
+    size_t Size() const      { return m_nSize; }
+    void Truncate(size_t nSize) { m_nSize = nSize; }
+    // removes [nBegin, nEnd) of the collected data
+    void Erase(size_t nBegin, size_t nEnd) {
+        ::memmove(m_buffer.data() + nBegin, m_buffer.data() + nEnd, m_nSize - nEnd);
+        m_nSize -= nEnd - nBegin;
+    }
+
+    // passes the collected data to the sink -> buffer is reused by the next element
+    void Flush();
+    // following elements go to the other sink
+    void SetFile(CSvgFileAbs *pFile) {
+        Flush();
+        m_pFile = pFile;
+    }
+
+private:
+    void Reserve(size_t nCount) {
+        const size_t nRequired = m_nSize + nCount;
+        if ( nRequired > m_buffer.size() ) {
+            Grow(nRequired);
+        }
+    }
+    void Grow(size_t nRequired);
+
+// Attributes
+private:
+    CSvgFileAbs *m_pFile;
+    std::vector<char> m_buffer;
+    size_t m_nSize {0};
+};
+
+#endif
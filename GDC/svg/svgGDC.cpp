@@ -1,9 +1,13 @@
 #include "stdafx.h"
 #include "svgGDC.h"
 
-#include "../GDC.h" 
+#include "../GDC.h"
 
-#include "fstream"
+#include "SvgFile.h"
+#include "SvgAsyncFile.h"
+#include "SvgGzipFile.h"
+#include "SvgPath.h"
+#include "SvgBoxPad.h"
 
 #ifdef _DEBUG
     #define new DEBUG_NEW
@@ -11,181 +15,59 @@
 
 const double SVG_PI	= 3.1415926535897932384626433832795;
 
-class CSvgFileAbs
-{
-// Construction/Desctruction
-public:
-    CSvgFileAbs() { }
-    virtual ~CSvgFileAbs() { }
-
-// Overrides
-public:
-    virtual void write(const char *sBuffer) = 0;
-};
-
-class CSvgFile : public CSvgFileAbs
-{
-// Construction/Desctruction
-public:
-    CSvgFile(const wchar_t *sFilePath) {
-        m_pFile = new std::ofstream;
-        m_pFile->open(sFilePath);
-        #ifdef _DEBUG // currently only for the debug
-        m_sFileName = sFilePath;
-        wchar_t drive[_MAX_DRIVE];
-        wchar_t dir[_MAX_DIR];
-        wchar_t fname[_MAX_FNAME];
-        wchar_t ext[_MAX_EXT];
-        ::_wsplitpath(m_sFileName.c_str(), drive, dir, fname, ext);
-        if ( ::wcscmp(ext, L".html") == 0) {
-            *m_pFile << "<html>";
-        }
-        #endif
-    }
-    virtual ~CSvgFile() {
-        #ifdef _DEBUG // currently only for the debug
-        wchar_t drive[_MAX_DRIVE];
-        wchar_t dir[_MAX_DIR];
-        wchar_t fname[_MAX_FNAME];
-        wchar_t ext[_MAX_EXT];
-        ::_wsplitpath(m_sFileName.c_str(), drive, dir, fname, ext);
-        if ( ::wcscmp(ext, L".html") == 0) {
-            *m_pFile << "</html>";
-        }
-        #endif
-
-        m_pFile->flush();
-        m_pFile->close();
-        delete m_pFile;
+CSvgFileAbs *SvgGDC::CreateSvgFile(GDCSvg &svg)
+{
+    if ( svg.m_pBuffer ) {
+        return new CSvgBuffer(svg.m_pBuffer);
     }
-
-// Overrides
-public:
-    virtual void write(const char *sBuffer) override {
-        *m_pFile << sBuffer;
+    const bool bCompress = svg.m_nCompression >= 0;
+    // async blocks are collected already -> written directly
+    const size_t nFileBlockSize = (svg.m_bAsyncWrite && !bCompress) ? 0 : svg.m_nFileBlockSize;
+    CSvgFileAbs *pFile = new CSvgFile(svg.GetFilePath(), nFileBlockSize, &svg.m_stats);
+    if ( bCompress ) {
+        pFile = new CSvgGzipFile(pFile, svg.m_nCompression);
     }
-
-// Attributes
-private:
-    #ifdef _DEBUG 
-    std::wstring m_sFileName;
-    #endif
-    std::ofstream *m_pFile;
-};
-
-class CSvgBuffer : public CSvgFileAbs
-{
-// Construction/Desctruction
-public:
-    CSvgBuffer(std::string *pBuffer) : m_pBuffer(pBuffer) { }
-    ~CSvgBuffer() { }
-
-// Overrides
-public:
-    virtual void write(const char *sBuffer) override {
-        *m_pBuffer += sBuffer;
+    if ( svg.m_bAsyncWrite ) {
+        // with the compression: deflate runs in the writer thread
+        pFile = new CSvgAsyncFile(pFile, svg.m_nFileBlockSize, 2);
     }
-
-// Attributes
-private:
-    std::string *m_pBuffer;
-};
-
-SvgGDC::SvgGDC(const wchar_t *sFilePath, int32_t nWidth, int32_t nHeight, bool bAutoSize, const char *sPrefix)
-{
-    m_pFile     = new CSvgFile(sFilePath);
-    m_nWidth    = nWidth;
-    m_nHeight   = nHeight;
-    m_bAutoSize = bAutoSize;
-    m_sPrefix   = sPrefix;
+    return pFile;
 }
 
-SvgGDC::SvgGDC(std::string *pBuffer, int32_t nWidth, int32_t nHeight, bool bAutoSize, const char *sPrefix)
+SvgGDC::SvgGDC(GDCSvg &svg)
+: m_pFile(CreateSvgFile(svg)),
+  m_pContent(svg.m_bDeferredHeader ? new CSvgChunkBuffer : nullptr),
+  m_writer(m_pContent ? m_pContent : m_pFile)
 {
-    m_pFile     = new CSvgBuffer(pBuffer);
-    m_nWidth    = nWidth;
-    m_nHeight   = nHeight;
-    m_bAutoSize = bAutoSize;
-    m_sPrefix   = sPrefix;
+    m_nWidth    = svg.Width();
+    m_nHeight   = svg.Height();
+    m_bAutoSize = svg.m_bAutoSize;
+    m_sPrefix   = svg.m_sPrefix;
+    m_bStyleClasses = svg.m_bStyleClasses;
+    m_bFitViewBox   = svg.m_bFitViewBox;
+    m_bMergeLines   = svg.m_bMergeLines;
+    m_bInstancing   = svg.m_bInstancing;
+    m_pStats        = &svg.m_stats;
+    m_bCulling      = svg.m_bCulling && !m_bFitViewBox; // fitted viewBox shows everything
+    m_bBoxes        = m_bCulling || m_bFitViewBox;
+    m_view          = CSvgBox(0, 0, m_nWidth, m_nHeight, 0);
 }
 
 SvgGDC::~SvgGDC()
 {
-    line("</svg>");
+    FlushLineRun();
+    if ( m_pContent ) {
+        WriteDeferredHeader();
+    }
+    else {
+        WriteStyleClasses();
+    }
+    m_writer.Line("</svg>");
+    // async writer: waits for the pending blocks
+    VERIFY(m_pFile->close()); // write error -> GDCSvgStats::m_bError
     delete m_pFile;
 }
 
-void SvgGDC::line(const char *val1) {
-    m_pFile->write(val1);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(val5);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(val5);
-    m_pFile->write(val6);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, 
-                  const char *val7) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(val5);
-    m_pFile->write(val6);
-    m_pFile->write(val7);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, 
-                  const char *val7, const char *val8) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(val5);
-    m_pFile->write(val6);
-    m_pFile->write(val7);
-    m_pFile->write(val8);
-    m_pFile->write(enter_elem());
-}
-void SvgGDC::line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, 
-                  const char *val7, const char *val8, const char *val9) {
-    m_pFile->write(val1);
-    m_pFile->write(val2);
-    m_pFile->write(val3);
-    m_pFile->write(val4);
-    m_pFile->write(val5);
-    m_pFile->write(val6);
-    m_pFile->write(val7);
-    m_pFile->write(val8);
-    m_pFile->write(val9);
-    m_pFile->write(enter_elem());
-}
-
 static inline std::string ColorToString(int32_t r, int32_t g, int32_t b)
 {
     std::string str  = "rgb(";
@@ -206,112 +88,79 @@ static inline std::string ColorToString(COLORREF color)
     return ColorToString(r, g, b);
 }
 
-static inline std::string ColorToStringRGBA(int32_t r, int32_t g, int32_t b, int32_t a)
+// rgb(r,g,b)
+static inline void AppendColor(CSvgWriter &writer, COLORREF color)
 {
-    std::string str  = "rgba(";
-                str += std::to_string(r);
-                str += ",";
-                str += std::to_string(g);
-                str += ",";
-                str += std::to_string(b);
-                str += ",";
-                str += std::to_string(a);
-                str += ")";
-    return str;
+    writer.Append("rgb(", 4);
+    writer.Append((int32_t)GetRValue(color));
+    writer.Append(',');
+    writer.Append((int32_t)GetGValue(color));
+    writer.Append(',');
+    writer.Append((int32_t)GetBValue(color));
+    writer.Append(')');
 }
 
-static inline std::string PaintColorToString(const GDCPaint &paint)
+// rgb(r,g,b) or rgba(r,g,b,a)
+static inline void AppendPaintColor(CSvgWriter &writer, const GDCPaint &paint)
 {
-    int32_t alfa = paint.GetAlfa();
+    const int32_t alfa = paint.GetAlfa();
     if ( alfa == -1 ) {
-        return ColorToString(paint.GetColor());
-    }
-    else {
-        const COLORREF color = paint.GetColor();
-        int32_t r = GetRValue(color);
-        int32_t g = GetGValue(color);
-        int32_t b = GetBValue(color);
-        return ColorToStringRGBA(r, g, b, alfa);
+        AppendColor(writer, paint.GetColor());
+        return;
     }
-}
 
-static inline std::string StrokeColor(const GDCPaint &paint)
-{
-    std::string str  = "stroke:";
-                str += PaintColorToString(paint);
-    return str;
-}
-// skia/include/core/SkString.h
-// Floats have at most 8 significant digits, so we limit our %g to that.
-// However, the total string could be 15 characters: -1.2345678e-005
-//
-//  In theory we should only expect up to 2 digits for the exponent, but on
-//  some platforms we have seen 3.
-#define SkStrAppendScalar_MaxSize  15
-static char* SkStrAppendFloat(char string[], float value) {
-    // SKIA: since floats have at most 8 significant digits, we limit our %g to that.
-    // https://stackoverflow.com/questions/12815179/number-of-significant-digits-for-a-floating-point-type
-    // according to the standard, not all decimal number can be stored exactly in memory. 
-    // Depending on the size of the representation, the error can get to a certain maximum. 
-    // For float this is 0.0001% (6 significant digits = 10^-6 = 10^-4 %).
-    // e.g: 0.85 -> results: 0.85000002 with the %.8g vs2017
-    static const char gFormat[] = "%.6g";
-    // make it 1 larger for the terminating 0
-    char buffer[SkStrAppendScalar_MaxSize + 1];
-    auto len = ::snprintf(buffer, sizeof(buffer), gFormat, value);
-    memcpy(string, buffer, len);
-    ASSERT(len <= SkStrAppendScalar_MaxSize);
-    return string + len;
-}
-static inline std::string float_to_string(float fValue)
-{
-    char  buffer[SkStrAppendScalar_MaxSize];
-    char *stop = SkStrAppendFloat(buffer, fValue);
-    const std::string sValue(buffer, stop - buffer);
-    return sValue;
+    const COLORREF color = paint.GetColor();
+    writer.Append("rgba(", 5);
+    writer.Append((int32_t)GetRValue(color));
+    writer.Append(',');
+    writer.Append((int32_t)GetGValue(color));
+    writer.Append(',');
+    writer.Append((int32_t)GetBValue(color));
+    writer.Append(',');
+    writer.Append(alfa);
+    writer.Append(')');
 }
 
-static inline std::string StrokeWidth(const GDCPaint &paint)
+static inline void AppendStrokeWidth(CSvgWriter &writer, const GDCPaint &paint)
 {
-    std::string str;
-
     float strokeWidth = paint.GetStrokeWidth();
-    
+
     if (strokeWidth == 0) { // SKIA version
         // Hairline stroke
         // https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/vector-effect
-        // The value "non-scaling-stroke" is designed so that it can be implemented 
-        // without the entire vector effect engine. For example, profiles of SVG may 
-        // restrict the values of vector-effect to be "default" or "non-scaling-stroke". 
-        // In effect this requires no processing of vector effects, rather it is always 
+        // The value "non-scaling-stroke" is designed so that it can be implemented
+        // without the entire vector effect engine. For example, profiles of SVG may
+        // restrict the values of vector-effect to be "default" or "non-scaling-stroke".
+        // In effect this requires no processing of vector effects, rather it is always
         // the default rendering order with a different set of transformations.
         strokeWidth = 1.f;
-        //str += "vector-effect:non-scaling-stroke;";   
-        // ISSUE 31 Values of vector-effect other than non-scaling-stroke and none are at risk of being dropped from SVG 2 
-        // due to a lack of implementations. Feedback from implementers is requested, regarding the practicality of implementing 
-        // them as currently specified, during the implementation period. 
+        //str += "vector-effect:non-scaling-stroke;";
+        // ISSUE 31 Values of vector-effect other than non-scaling-stroke and none are at risk of being dropped from SVG 2
+        // due to a lack of implementations. Feedback from implementers is requested, regarding the practicality of implementing
+        // them as currently specified, during the implementation period.
     }
-    else if (strokeWidth < 0.85f) { // if lines are not visible -> please try to disable all external css -> could be an issue with the css 
+    else if (strokeWidth < 0.85f) { // if lines are not visible -> please try to disable all external css -> could be an issue with the css
         strokeWidth = 0.85f; // due the antialiasing: crispEdges everything bellow ~0.81px is not visible with the 100% zoom
     }
 
-    // https://css-tricks.com/almanac/properties/s/stroke-width/    
+    // https://css-tricks.com/almanac/properties/s/stroke-width/
     // stroke-width: 2px
     // stroke-width: 2em
     // stroke-width: 2
     // stroke-width: 2.5
     // stroke-width: 15%
-    str += "stroke-width:";     
-    str += float_to_string(strokeWidth);
-    //str += "px"; // e.g.: skia uses always svg defined units 
-    return str;
+    writer.Append("stroke-width:");
+    writer.Append(strokeWidth);
+    //str += "px"; // e.g.: skia uses always svg defined units
 }
 
-static inline std::string Stroke(const GDCPaint &paint)
+// stroke:rgb(..);stroke-width:..;stroke-dasharray:..
+static inline void AppendStroke(CSvgWriter &writer, const GDCPaint &paint)
 {
-    std::string str = StrokeColor(paint);
-                str  += ";";
-                str  += StrokeWidth(paint);
+    writer.Append("stroke:");
+    AppendPaintColor(writer, paint);
+    writer.Append(';');
+    AppendStrokeWidth(writer, paint);
 
     // https://www.w3schools.com/graphics/tryit.asp?filename=trysvg_stroke3
     const GDCStrokeType stroke = paint.GetStrokeType();
@@ -319,40 +168,134 @@ static inline std::string Stroke(const GDCPaint &paint)
     {
     case GDC_PS_SOLID:
         break;
-    case GDC_PS_DASH: {
-            str += ";";
-            str += "stroke-dasharray:20,10";
-        }
+    case GDC_PS_DASH:
+        writer.Append(";stroke-dasharray:20,10");
         break;
-    case GDC_PS_DOT: {
-            str += ";";
-            str += "stroke-dasharray:5,5";
-        }
+    case GDC_PS_DOT:
+        writer.Append(";stroke-dasharray:5,5");
         break;
-    case GDC_PS_DASHDOT: {
-            str += ";";
-            str += "stroke-dasharray:20,5,5,5"; // stroke-length, space-length, stroke-length, ...
-        }
+    case GDC_PS_DASHDOT:
+        writer.Append(";stroke-dasharray:20,5,5,5"); // stroke-length, space-length, stroke-length, ...
         break;
-    case GDC_PS_DASHDOTDOT: {
-            str += ";";
-            str += "stroke-dasharray:20,5,5,5,5,5"; // stroke-length, space-length, stroke-length, ...
-        }
+    case GDC_PS_DASHDOTDOT:
+        writer.Append(";stroke-dasharray:20,5,5,5,5,5"); // stroke-length, space-length, stroke-length, ...
         break;
     }
-    return str;
+}
+
+static inline void AppendFillColor(CSvgWriter &writer, const GDCPaint &paint)
+{
+    writer.Append("fill:");
+    AppendPaintColor(writer, paint);
+}
+
+//  points="x,y x,y ..."
+static inline void AppendPoints(CSvgWriter &writer, const GDCPoints &points, bool bClose, const GDCPoint &org)
+{
+    writer.BeginAttr("points");
+    bool bFirst = true;
+    for (const GDCPoint pt : points) {
+        if ( !bFirst ) {
+            writer.Append(' ');
+        }
+        writer.AppendPoint(pt.x - org.x, pt.y - org.y);
+        bFirst = false;
+    }
+    if ( bClose && !points.empty() ) {
+        writer.Append(' ');
+        writer.AppendPoint(points.front().x - org.x, points.front().y - org.y);
+    }
+    writer.EndAttr();
+}
+
+// number in the path data: separator is not required before '-' or after the command letter
+static inline void AppendPathNumber(CSvgWriter &writer, int32_t nValue, bool bSeparate)
+{
+    if ( bSeparate && nValue >= 0 ) {
+        writer.Append(' ');
+    }
+    writer.Append(nValue);
+}
+
+//  d="Mx y..." relative coordinates, h/v for the axis aligned segments,
+//  repeated commands are implicit, closed ring ends with z.
+static void AppendPathData(CSvgWriter &writer, const GDCPoints &points, bool bClose, const GDCPoint &org)
+{
+    writer.BeginAttr("d");
+    size_t nCount = points.size();
+    if ( bClose && nCount > 1 && points.front().x == points.back().x && points.front().y == points.back().y ) {
+        --nCount; // z draws the closing segment
+    }
+
+    writer.Append('M');
+    writer.Append(points.X(0) - org.x);
+    AppendPathNumber(writer, points.Y(0) - org.y, true);
+
+    char cCmd = 'M'; // next "M" pairs would be absolute -> the first relative segment always gets the letter
+    for (size_t i = 1; i < nCount; ++i) {
+        const int32_t dx = points.X(i) - points.X(i - 1);
+        const int32_t dy = points.Y(i) - points.Y(i - 1);
+        const char cNext = (dy == 0) ? 'h' : (dx == 0) ? 'v' : 'l';
+        const bool bSeparate = (cNext == cCmd);
+        if ( !bSeparate ) {
+            writer.Append(cNext);
+            cCmd = cNext;
+        }
+        switch ( cNext )
+        {
+        case 'h':
+            AppendPathNumber(writer, dx, bSeparate);
+            break;
+        case 'v':
+            AppendPathNumber(writer, dy, bSeparate);
+            break;
+        default:
+            AppendPathNumber(writer, dx, bSeparate);
+            AppendPathNumber(writer, dy, true);
+            break;
+        }
+    }
+
+    if ( bClose ) {
+        writer.Append('z');
+    }
+    writer.EndAttr();
+}
+
+// <sTag points="..." or <path d="..." whichever is shorter, coordinates are relative to the org
+static void BeginPolyElem(CSvgWriter &writer, const char *sTag, const GDCPoints &points, bool bClosePoints, bool bClosePath,
+                          const GDCPoint &org = GDCPoint(0, 0))
+{
+    if ( points.empty() ) {
+        writer.BeginElem(sTag);
+        ::AppendPoints(writer, points, bClosePoints, org);
+        return;
+    }
+
+    const size_t nPathBegin = writer.Size();
+    writer.BeginElem("path");
+    ::AppendPathData(writer, points, bClosePath, org);
+    const size_t nPathEnd = writer.Size();
+
+    writer.BeginElem(sTag);
+    ::AppendPoints(writer, points, bClosePoints, org);
+
+    if ( writer.Size() - nPathEnd < nPathEnd - nPathBegin ) {
+        writer.Erase(nPathBegin, nPathEnd);
+    }
+    else {
+        writer.Truncate(nPathEnd);
+    }
 }
 
 inline static std::string CreatePatern(const char *sColor, const char *sPaternName, const char *sPaternPath)
 {
-    std::string sValue = "<defs>";
-        sValue += "<pattern id=\""; sValue += sPaternName; sValue += "\" patternUnits=\"userSpaceOnUse\" width=\"10\" height=\"10\">";
-            sValue += "<svg width='10' height='10'>";
-            sValue += "<rect width='10' height='10' fill='none'/>";
-                sValue += "<path d='";  sValue += sPaternPath; sValue += "' stroke='"; sValue += sColor;  sValue += "' stroke-width='1'/> ";
-            sValue += "</svg>";
-        sValue += "</pattern>";
-    sValue += "</defs>";
+    std::string sValue = "<pattern id=\""; sValue += sPaternName; sValue += "\" patternUnits=\"userSpaceOnUse\" width=\"10\" height=\"10\">";
+        sValue += "<svg width='10' height='10'>";
+        sValue += "<rect width='10' height='10' fill='none'/>";
+            sValue += "<path d='";  sValue += sPaternPath; sValue += "' stroke='"; sValue += sColor;  sValue += "' stroke-width='1'/> ";
+        sValue += "</svg>";
+    sValue += "</pattern>";
     return sValue;
 }
 
@@ -386,40 +329,26 @@ inline static std::string CreateCrossPatern(const char *sColor, const char *sPat
     return CreatePatern(sColor, sPaternName, "M0 1L10 1M1 0L1 10");
 }
 
-static inline std::string FillColor(const GDCPaint &paint)
-{
-    std::string str  = "fill:";
-                str += PaintColorToString(paint);
-    return str;
-}
-
-static inline std::string FillPattern(const char *sPatternId)
-{
-    std::string str  = "fill:url(#";
-                str += sPatternId;
-                str += ")";
-    return str;
-}
-
-std::string SvgGDC::GetPattern(const GDCPaint &fill_paint)
+const std::string *SvgGDC::GetPattern(const GDCPaint &fill_paint)
 {
     const GDCPaintType eFill = fill_paint.GetPaintType();
-    if (eFill <= GDC_FILL) {
-        return "";
+    if (eFill <= GDC_FILL || eFill > GDC_FILL_CROSS) {
+        return nullptr;
     }
 
     const COLORREF color = fill_paint.GetColor();
     // Patterns with different colors support
+    const uint64_t nKey = ((uint64_t)eFill << 32) | color;
+    const std::string *pPatternName = m_patterns.Find(nKey);
+    if ( pPatternName ) {
+        return pPatternName;
+    }
+
     std::string sPatternName = m_sPrefix;
     sPatternName += std::to_string(eFill);
     sPatternName += '-';
     sPatternName += std::to_string(color);
 
-    auto it_find = std::find(m_patterns.begin(), m_patterns.end(), sPatternName);
-    if (m_patterns.end() != it_find) {
-        return sPatternName;
-    }
-
     const std::string sColor = ColorToString(color);
     std::string sPatternDef;
     //If pattern doesn't exist - create and write to file
@@ -450,100 +379,345 @@ std::string SvgGDC::GetPattern(const GDCPaint &fill_paint)
         }
         break;
     default:
-        return "";
+        return nullptr;
         break;
     }
 
-    m_patterns.push_back(sPatternName);
-    line(sPatternDef.c_str());
+    WriteDefs(sPatternDef);
 
-    return sPatternName;
+    return &m_patterns.Add(nKey, std::move(sPatternName));
 }
 
-void SvgGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) 
+void SvgGDC::AppendFill(const GDCPaint &fill_paint, const std::string *pPatternName)
 {
-     std::string sStyle   = "\" style=\"";
-                 sStyle  += Stroke(paint);
-                 sStyle  += "\" />";
+    if ( !pPatternName ) {
+        ::AppendFillColor(m_writer, fill_paint);
+        return;
+    }
+    m_writer.Append("fill:url(#");
+    m_writer.Append(pPatternName->c_str(), pPatternName->size());
+    m_writer.Append(')');
+}
 
-     line("<line x1=\"", std::to_string(x1).c_str(),
-             "\" y1=\"", std::to_string(y1).c_str(),
-             "\" x2=\"", std::to_string(x2).c_str(), 
-             "\" y2=\"", std::to_string(y2).c_str(), 
-             sStyle.c_str());
+void SvgGDC::BeginStyle()
+{
+    m_nStyleAttr = m_writer.Size();
+    m_writer.BeginAttr("style");
+    m_nStyleBegin = m_writer.Size();
 }
 
-void SvgGDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) 
+// style="..." -> class="sN", every distinct style is interned once
+void SvgGDC::EndStyle()
 {
-    const std::string sRad = std::to_string(paint.GetStrokeWidth());
-    const std::string sFill = FillColor(paint);
-    line("<circle cx=\"", std::to_string(x).c_str(), "\" cy=\"", std::to_string(y).c_str(), "\" r=\"", sRad.c_str(), "\" style=\"", sFill.c_str(), "\"/>");
+    if ( !m_bStyleClasses ) {
+        m_writer.EndAttr();
+        return;
+    }
+
+    const std::string_view sStyle(m_writer.Data() + m_nStyleBegin, m_writer.Size() - m_nStyleBegin);
+    int32_t nClass = 0;
+    auto found = m_style_classes.find(sStyle);
+    if ( found == m_style_classes.end() ) {
+        nClass = (int32_t)m_styles.size();
+        m_styles.emplace_back(sStyle);
+        m_style_classes.emplace(std::string_view(m_styles.back()), nClass);
+    }
+    else {
+        nClass = found->second;
+    }
+
+    m_writer.Truncate(m_nStyleAttr);
+    m_writer.BeginAttr("class");
+    m_writer.Append(m_sPrefix.c_str(), m_sPrefix.size());
+    m_writer.Append('s');
+    m_writer.Append(nClass);
+    m_writer.EndAttr();
 }
 
-static inline std::string PointToStr(const GDCPoint &pt) {
-    std::string str  = std::to_string(pt.x);
-                str += ",";
-                str += std::to_string(pt.y);
-    return str;
+// style sheet is global for the document -> position in the svg does not matter
+void SvgGDC::WriteStyleClasses()
+{
+    if ( m_styles.empty() ) {
+        return;
+    }
+    m_writer.Append("<style>\n");
+    int32_t nClass = 0;
+    for (const std::string &sStyle : m_styles) {
+        m_writer.Append('.');
+        m_writer.Append(m_sPrefix.c_str(), m_sPrefix.size());
+        m_writer.Append('s');
+        m_writer.Append(nClass++);
+        m_writer.Append('{');
+        m_writer.Append(sStyle.c_str(), sStyle.size());
+        m_writer.Append("}\n", 2);
+        m_writer.Flush();
+    }
+    m_writer.Line("</style>");
 }
 
-static inline std::string PointsToStr(const std::vector<GDCPoint> &points) {
-    std::string str = "\"";
-    for (const auto &pt : points) {
-        str += PointToStr(pt);
-        str += " ";
+bool SvgGDC::IsVisible(const CSvgBox &box)
+{
+    if ( m_bCulling && !m_view.Intersects(box) ) {
+        ++m_pStats->m_nCulled;
+        return false;
     }
-    str += "\"";
-    return str;
+    if ( m_bFitViewBox ) {
+        m_extents.Add(box);
+    }
+    return true;
 }
 
-std::string SvgGDC::GetFill(const GDCPaint &fill_paint)
+void SvgGDC::OpenGroups()
 {
-    const std::string sPatternName = GetPattern(fill_paint);
-    std::string sFill;
-    if (!sPatternName.empty()) {
-        sFill = ::FillPattern(sPatternName.c_str());
+    for (const std::string &sGroupAttributes : m_pending_groups) {
+        m_writer.Append("<g ", 3);
+        m_writer.Append(sGroupAttributes.c_str(), sGroupAttributes.size());
+        m_writer.Append(">\n", 2);
+        m_writer.Flush();
     }
-    else {
-        sFill = ::FillColor(fill_paint);
+    m_pending_groups.clear();
+}
+
+void SvgGDC::WriteDefs(const std::string &sDef)
+{
+    if ( m_pContent ) {
+        m_defs += sDef;
+        m_defs += '\n';
+        return;
     }
+    m_writer.Append("<defs>", 6);
+    m_writer.Append(sDef.c_str(), sDef.size());
+    m_writer.Line("</defs>");
+}
 
-    return sFill;
+// <svg> root, <defs> and <style> go in front of the collected content
+void SvgGDC::WriteDeferredHeader()
+{
+    m_writer.SetFile(m_pFile);
+    if ( m_bRootPending ) {
+        WriteRoot(m_xOrg, m_yOrg);
+    }
+    if ( !m_defs.empty() ) {
+        m_writer.Line("<defs>");
+        m_pFile->write(m_defs.c_str(), m_defs.size());
+        m_writer.Line("</defs>");
+    }
+    WriteStyleClasses();
+    m_pContent->WriteTo(m_pFile);
+    delete m_pContent;
+    m_pContent = nullptr;
 }
 
-void SvgGDC::DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) 
+// small shapes only: the element is kept as the key
+#define SVG_INSTANCE_MAX_POINTS 32
+
+// memory limit of the document: new elements are written as is
+#define SVG_INSTANCE_MAX_ELEMS 16384
+
+// same element (geometry relative to the org and style) is the <symbol> from the second occurrence, the first one is written as is
+template <class TWriteElem>
+void SvgGDC::WriteInstance(bool bInstance, int32_t x, int32_t y, const TWriteElem &WriteElem)
 {
-    const std::string sFill   = GetFill(fill_paint);
-    const std::string sPoints = ::PointsToStr(points);
-    line("<polygon points=", sPoints.c_str(), " style=\"", sFill.c_str(), ";", Stroke(stroke_paint).c_str(), "\" />");
+    if ( m_bInstancing && bInstance ) {
+        const size_t nElemBegin = m_writer.Size(); // nothing is passed to the sink until the element end
+        WriteElem(GDCPoint(x, y));
+        m_writer.Append("/>", 2);
+        if ( WriteUse(nElemBegin, x, y) ) {
+            return;
+        }
+    }
+    WriteElem(GDCPoint(0, 0));
+    m_writer.EndElem();
+}
+
+// false: element is not repeated (yet) -> it is truncated
+bool SvgGDC::WriteUse(size_t nElemBegin, int32_t x, int32_t y)
+{
+    const std::string_view sElem(m_writer.Data() + nElemBegin, m_writer.Size() - nElemBegin);
+    auto found = m_instances.find(sElem);
+    if ( found == m_instances.end() ) {
+        if ( m_instance_elems.size() < SVG_INSTANCE_MAX_ELEMS ) {
+            m_instance_elems.emplace_back(sElem);
+            m_instances.emplace(std::string_view(m_instance_elems.back()), -1);
+        }
+        m_writer.Truncate(nElemBegin);
+        return false;
+    }
+    m_writer.Truncate(nElemBegin);
+
+    if ( found->second == -1 ) {
+        found->second = m_nSymbols++;
+        std::string sSymbol = "<symbol id=\"";
+        sSymbol += m_sPrefix;
+        sSymbol += 'i';
+        sSymbol += std::to_string(found->second);
+        sSymbol += "\" overflow=\"visible\">";
+        sSymbol += found->first;
+        sSymbol += "</symbol>";
+        WriteDefs(sSymbol);
+    }
+
+    m_writer.BeginElem("use");
+    m_writer.BeginAttr("xlink:href");
+    m_writer.Append('#');
+    m_writer.Append(m_sPrefix.c_str(), m_sPrefix.size());
+    m_writer.Append('i');
+    m_writer.Append(found->second);
+    m_writer.EndAttr();
+    m_writer.Attr("x", x);
+    m_writer.Attr("y", y);
+    m_writer.EndElem();
+    return true;
 }
 
-void SvgGDC::DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) 
+// <path style="..." d="Mx yLx y...": attributes order does not matter -> d is the last one and can grow.
+// Every segment is the separate subpath: caps and dashes are the same as for the separate lines.
+void SvgGDC::AppendLineRun(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
-    std::vector<GDCPoint> points2 = points;
-    points2.push_back(points.front());
-    DrawPolyLine(points2, stroke_paint);
+    if ( m_bLineRun && (m_run_color != paint.GetColor() || m_fRunWidth != paint.GetStrokeWidth() || m_nRunStrokeType != (int32_t)paint.GetStrokeType()) ) {
+        EndLineRun();
+    }
+
+    if ( !m_bLineRun ) {
+        OpenGroups();
+        m_bLineRun        = true;
+        m_run_color       = paint.GetColor();
+        m_fRunWidth       = paint.GetStrokeWidth();
+        m_nRunStrokeType  = (int32_t)paint.GetStrokeType();
+
+        m_writer.BeginElem("path");
+        BeginStyle();
+        m_writer.Append("fill:none;");
+        ::AppendStroke(m_writer, paint);
+        EndStyle();
+        m_writer.BeginAttr("d");
+    }
+
+    m_writer.Append('M');
+    m_writer.Append(x1);
+    ::AppendPathNumber(m_writer, y1, true);
+    m_writer.Append('L');
+    m_writer.Append(x2);
+    ::AppendPathNumber(m_writer, y2, true);
+
+    if ( m_writer.Size() >= 64 * 1024 ) {
+        m_writer.Flush(); // nothing can be written in between -> long runs do not grow the buffer
+    }
 }
 
-void SvgGDC::DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) 
+void SvgGDC::EndLineRun()
 {
-    std::string sPoints = ::PointsToStr(points);
-    line("<polyline points=", sPoints.c_str(), " style=\"fill:none;", Stroke(stroke_paint).c_str(), "\" />");
+    m_bLineRun = false;
+    m_writer.EndAttr();
+    m_writer.EndElem();
 }
-    
-void SvgGDC::DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint) 
+
+void SvgGDC::DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
+{
+    if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, ::GetStrokePad(paint))) ) {
+        return;
+    }
+
+    // transparent lines are not merged: overlapping segments of the one path are blended once
+    if ( m_bMergeLines && paint.GetAlfa() == -1 ) {
+        AppendLineRun(x1, y1, x2, y2, paint);
+        return;
+    }
+
+    BeginOutput();
+    m_writer.BeginElem("line");
+    m_writer.Attr("x1", x1);
+    m_writer.Attr("y1", y1);
+    m_writer.Attr("x2", x2);
+    m_writer.Attr("y2", y2);
+    BeginStyle();
+    ::AppendStroke(m_writer, paint);
+    EndStyle();
+    m_writer.EndElem();
+}
+
+void SvgGDC::DrawPoint(int32_t x, int32_t y, const GDCPaint &paint)
+{
+    if ( m_bBoxes && !IsVisible(CSvgBox(x, y, x, y, (int32_t)paint.GetStrokeWidth() + 1)) ) {
+        return;
+    }
+    BeginOutput();
+
+    WriteInstance(true, x, y, [&](const GDCPoint &org) {
+        m_writer.BeginElem("circle");
+        m_writer.Attr("cx", x - org.x);
+        m_writer.Attr("cy", y - org.y);
+        m_writer.Attr("r", paint.GetStrokeWidth());
+        BeginStyle();
+        ::AppendFillColor(m_writer, paint);
+        EndStyle();
+    });
+}
+
+void SvgGDC::DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    if ( m_bBoxes && !IsVisible(CSvgBox(points, ::GetStrokePad(stroke_paint))) ) {
+        return;
+    }
+    BeginOutput();
+    const std::string *pPatternName = GetPattern(fill_paint); // pattern definition goes before the element
+
+    const bool bInstance = !points.empty() && points.size() <= SVG_INSTANCE_MAX_POINTS;
+    WriteInstance(bInstance, bInstance ? points.X(0) : 0, bInstance ? points.Y(0) : 0, [&](const GDCPoint &org) {
+        ::BeginPolyElem(m_writer, "polygon", points, false, true, org);
+        BeginStyle();
+        AppendFill(fill_paint, pPatternName);
+        m_writer.Append(';');
+        ::AppendStroke(m_writer, stroke_paint);
+        EndStyle();
+    });
+}
+
+void SvgGDC::DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    if ( m_bBoxes && !IsVisible(CSvgBox(points, ::GetStrokePad(stroke_paint))) ) {
+        return;
+    }
+    BeginOutput();
+
+    const bool bInstance = !points.empty() && points.size() <= SVG_INSTANCE_MAX_POINTS;
+    WriteInstance(bInstance, bInstance ? points.X(0) : 0, bInstance ? points.Y(0) : 0, [&](const GDCPoint &org) {
+        ::BeginPolyElem(m_writer, "polyline", points, true, true, org);
+        BeginStyle();
+        m_writer.Append("fill:none;");
+        ::AppendStroke(m_writer, stroke_paint);
+        EndStyle();
+    });
+}
+
+void SvgGDC::DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint)
+{
+    if ( m_bBoxes && !IsVisible(CSvgBox(points, ::GetStrokePad(stroke_paint))) ) {
+        return;
+    }
+    BeginOutput();
+
+    const bool bInstance = !points.empty() && points.size() <= SVG_INSTANCE_MAX_POINTS;
+    WriteInstance(bInstance, bInstance ? points.X(0) : 0, bInstance ? points.Y(0) : 0, [&](const GDCPoint &org) {
+        ::BeginPolyElem(m_writer, "polyline", points, false, false, org);
+        BeginStyle();
+        m_writer.Append("fill:none;");
+        ::AppendStroke(m_writer, stroke_paint);
+        EndStyle();
+    });
+}
+
+void SvgGDC::DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint)
 {
     ASSERT(FALSE); // implementation is missing - TODO
 }
 
 inline static std::string CreateHorizontalGradient(const char *sColorFrom, const char *sColorTo, const char *sGradId)
 {
-    std::string sValue = "<defs>";
-        sValue += "<linearGradient id=\""; sValue += sGradId; sValue += "\" x1=\"0%\" y1=\"0%\" x2=\"100%\" y2=\"0%\">";
-        sValue += "<stop offset=\"0%\" style=\"stop-color:"; sValue += sColorFrom; sValue += ";stop-opacity:1\" />";
-        sValue += "<stop offset=\"100%\" style=\"stop-color:", sValue += sColorTo; sValue += ";stop-opacity:1\" />";
-        sValue += "</linearGradient>";
-    sValue += "</defs>";
+    std::string sValue = "<linearGradient id=\""; sValue += sGradId; sValue += "\" x1=\"0%\" y1=\"0%\" x2=\"100%\" y2=\"0%\">";
+    sValue += "<stop offset=\"0%\" style=\"stop-color:"; sValue += sColorFrom; sValue += ";stop-opacity:1\" />";
+    sValue += "<stop offset=\"100%\" style=\"stop-color:", sValue += sColorTo; sValue += ";stop-opacity:1\" />";
+    sValue += "</linearGradient>";
     return sValue;
 }
 
@@ -557,99 +731,532 @@ void SvgGDC::DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar
     ASSERT(FALSE); // implementation is missing - TODO
 }
 
-void SvgGDC::DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) 
+void SvgGDC::DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo)
 {
+    if ( m_bBoxes && !IsVisible(CSvgBox(points, ::GetStrokePad(paintFrom))) ) {
+        return;
+    }
+    BeginOutput();
+
     const COLORREF color_from = paintFrom.GetColor();
     const COLORREF color_to   = paintTo.GetColor();
-    
-    const std::string sColorFrom = ColorToString(color_from);
-    const std::string sColorTo   = ColorToString(color_to);
-
-    std::string sGradId;
 
-    std::string sGradColor = sColorFrom + sColorTo;
-    auto found = m_horizontal_grads.find(sGradColor);
-    if ( found == m_horizontal_grads.end() ) {
-        sGradId = "grad";
+    const uint64_t nKey = ((uint64_t)color_from << 32) | color_to;
+    const std::string *pGradId = m_horizontal_grads.Find(nKey);
+    if ( !pGradId ) {
+        std::string sGradId = "grad";
         sGradId += m_sPrefix;
-        sGradId += std::to_string(m_horizontal_grads.size() + 1);
+        sGradId += std::to_string(m_horizontal_grads.Size() + 1);
+        const std::string sColorFrom = ColorToString(color_from);
+        const std::string sColorTo   = ColorToString(color_to);
         const std::string sGradient = ::CreateHorizontalGradient(sColorFrom.c_str(), sColorTo.c_str(), sGradId.c_str()); // do generate only once
-        line(sGradient.c_str());
-        m_horizontal_grads[sGradColor] = sGradId.c_str();
+        WriteDefs(sGradient);
+        pGradId = &m_horizontal_grads.Add(nKey, std::move(sGradId));
     }
-    else {
-        sGradId = found->second;
-    }
-    
-    std::string sPoints = PointsToStr(points);
-    line("<polygon points=", sPoints.c_str(), " style=\"fill:url(#", sGradId.c_str(), ")", "\" />");
+
+    ::BeginPolyElem(m_writer, "polygon", points, false, true);
+    BeginStyle();
+    m_writer.Append("fill:url(#");
+    m_writer.Append(pGradId->c_str(), pGradId->size());
+    m_writer.Append(')');
+    EndStyle();
+    m_writer.EndElem();
 }
 
-void SvgGDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) 
+void SvgGDC::DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint)
 {
     ASSERT(FALSE);  // implementation is missing - TODO
 }
 
-void SvgGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) 
+void SvgGDC::DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
-    std::string sStyle  = "style=\"fill:none;";
-                sStyle += Stroke(paint).c_str();
+    if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, ::GetStrokePad(paint))) ) {
+        return;
+    }
+    BeginOutput();
 
     const int32_t nWidth  = ::abs(x2 - x1);
     const int32_t nHeight = ::abs(y2 - y1);
-    std::string sWidth  = "width=\"";
-                sWidth += std::to_string(nHeight).c_str();
-                sWidth += "\"";
-    std::string sHeight  = "height=\"";
-                sHeight += std::to_string(nHeight).c_str();
-                sHeight += "\"";
 
-    std::string sX  = "x=\"";
-                sX += std::to_string(x1);
-                sX += "\"";
-    std::string sY = "y=\"";
-                sY += std::to_string(y1);
-                sY += "\"";
-    std::string sXY = sX + " " + sY;
+    WriteInstance(true, x1, y1, [&](const GDCPoint &org) {
+        m_writer.BeginElem("rect");
+        m_writer.Attr("x", x1 - org.x);
+        m_writer.Attr("y", y1 - org.y);
+        m_writer.Attr("width",  nWidth);
+        m_writer.Attr("height", nHeight);
+        BeginStyle();
+        m_writer.Append("fill:none;");
+        ::AppendStroke(m_writer, paint);
+        EndStyle();
+    });
+}
+
+// Mx y and the relative segment
+static inline void AppendSegment(CSvgWriter &writer, int32_t x1, int32_t y1, int32_t x2, int32_t y2)
+{
+    writer.Append('M');
+    writer.Append(x1);
+    ::AppendPathNumber(writer, y1, true);
+    const int32_t dx = x2 - x1;
+    const int32_t dy = y2 - y1;
+    if ( dy == 0 ) {
+        writer.Append('h');
+        writer.Append(dx);
+    }
+    else if ( dx == 0 ) {
+        writer.Append('v');
+        writer.Append(dy);
+    }
+    else {
+        writer.Append('l');
+        writer.Append(dx);
+        ::AppendPathNumber(writer, dy, true);
+    }
+}
+
+void SvgGDC::BeginBatch(const GDCPaint &paint, bool bPoints)
+{
+    BeginOutput();
+    m_writer.BeginElem("path");
+    BeginStyle();
+    m_writer.Append("fill:none;");
+    if ( bPoints ) {
+        // zero length subpaths with the round caps: circles of the DrawPoint radius
+        m_writer.Append("stroke:");
+        ::AppendPaintColor(m_writer, paint);
+        m_writer.Append(";stroke-width:");
+        m_writer.Append(2.f * paint.GetStrokeWidth());
+        m_writer.Append(";stroke-linecap:round");
+    }
+    else {
+        ::AppendStroke(m_writer, paint);
+    }
+    EndStyle();
+    m_writer.BeginAttr("d");
+}
+
+void SvgGDC::EndBatch()
+{
+    m_writer.EndAttr();
+    m_writer.EndElem();
+}
+
+// overlapping transparent segments are blended once (single path)
+void SvgGDC::DrawLines(const GDCPoints &points, const GDCPaint &paint)
+{
+    const int32_t nPad = ::GetStrokePad(paint);
+    const size_t nCount = points.size() & ~(size_t)1;
+    bool bBatch = false;
+    for (size_t i = 0; i < nCount; i += 2) {
+        const int32_t x1 = points.X(i);
+        const int32_t y1 = points.Y(i);
+        const int32_t x2 = points.X(i + 1);
+        const int32_t y2 = points.Y(i + 1);
+        if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, nPad)) ) {
+            continue;
+        }
+        if ( !bBatch ) {
+            BeginBatch(paint, false);
+            bBatch = true;
+        }
+        ::AppendSegment(m_writer, x1, y1, x2, y2);
+        if ( m_writer.Size() >= 64 * 1024 ) {
+            m_writer.Flush();
+        }
+    }
+    if ( bBatch ) {
+        EndBatch();
+    }
+}
+
+void SvgGDC::DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint)
+{
+    const int32_t nPad = ::GetStrokePad(stroke_paint);
+    const size_t nCount = corners.size() & ~(size_t)1;
+    bool bBatch = false;
+    for (size_t i = 0; i < nCount; i += 2) {
+        const int32_t x1 = (std::min)(corners.X(i), corners.X(i + 1));
+        const int32_t y1 = (std::min)(corners.Y(i), corners.Y(i + 1));
+        const int32_t x2 = (std::max)(corners.X(i), corners.X(i + 1));
+        const int32_t y2 = (std::max)(corners.Y(i), corners.Y(i + 1));
+        if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, nPad)) ) {
+            continue;
+        }
+        if ( !bBatch ) {
+            BeginBatch(stroke_paint, false);
+            bBatch = true;
+        }
+        m_writer.Append('M');
+        m_writer.Append(x1);
+        ::AppendPathNumber(m_writer, y1, true);
+        m_writer.Append('h');
+        m_writer.Append(x2 - x1);
+        m_writer.Append('v');
+        m_writer.Append(y2 - y1);
+        m_writer.Append('h');
+        m_writer.Append(x1 - x2);
+        m_writer.Append('z');
+        if ( m_writer.Size() >= 64 * 1024 ) {
+            m_writer.Flush();
+        }
+    }
+    if ( bBatch ) {
+        EndBatch();
+    }
+}
+
+void SvgGDC::DrawPoints(const GDCPoints &points, const GDCPaint &paint)
+{
+    const int32_t nPad = (int32_t)paint.GetStrokeWidth() + 1;
+    bool bBatch = false;
+    for (const GDCPoint pt : points) {
+        if ( m_bBoxes && !IsVisible(CSvgBox(pt.x, pt.y, pt.x, pt.y, nPad)) ) {
+            continue;
+        }
+        if ( !bBatch ) {
+            BeginBatch(paint, true);
+            bBatch = true;
+        }
+        ::AppendSegment(m_writer, pt.x, pt.y, pt.x, pt.y);
+        if ( m_writer.Size() >= 64 * 1024 ) {
+            m_writer.Flush();
+        }
+    }
+    if ( bBatch ) {
+        EndBatch();
+    }
+}
+
+//  points="x,y x,y ..." sub-pixel coordinates
+static inline void AppendPointsF(CSvgWriter &writer, const GDCPointF *pPoints, size_t nCount)
+{
+    writer.BeginAttr("points");
+    for (size_t i = 0; i < nCount; ++i) {
+        if ( i > 0 ) {
+            writer.Append(' ');
+        }
+        writer.AppendPointF(pPoints[i].x, pPoints[i].y);
+    }
+    writer.EndAttr();
+}
+
+// clamped: pad is added without the overflow
+static inline int32_t GetBoxCoord(double dValue)
+{
+    return (int32_t)(std::max)(-1073741824., (std::min)(1073741824., dValue));
+}
+
+static inline CSvgBox GetSvgBoxF(const GDCPointF *pPoints, size_t nCount, int32_t nPad)
+{
+    CSvgBox box;
+    for (size_t i = 0; i < nCount; ++i) {
+        box.Add(::GetBoxCoord(::floor(pPoints[i].x)), ::GetBoxCoord(::floor(pPoints[i].y)), nPad);
+        box.Add(::GetBoxCoord(::ceil(pPoints[i].x)), ::GetBoxCoord(::ceil(pPoints[i].y)), nPad);
+    }
+    return box;
+}
+
+void SvgGDC::DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint)
+{
+    const GDCPointF points[2] = { GDCPointF(x1, y1), GDCPointF(x2, y2) };
+    if ( m_bBoxes && !IsVisible(::GetSvgBoxF(points, 2, ::GetStrokePad(paint))) ) {
+        return;
+    }
+    BeginOutput();
+    m_writer.BeginElem("line");
+    m_writer.BeginAttr("x1"); m_writer.AppendFixed(x1); m_writer.EndAttr();
+    m_writer.BeginAttr("y1"); m_writer.AppendFixed(y1); m_writer.EndAttr();
+    m_writer.BeginAttr("x2"); m_writer.AppendFixed(x2); m_writer.EndAttr();
+    m_writer.BeginAttr("y2"); m_writer.AppendFixed(y2); m_writer.EndAttr();
+    BeginStyle();
+    ::AppendStroke(m_writer, paint);
+    EndStyle();
+    m_writer.EndElem();
+}
+
+void SvgGDC::DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint)
+{
+    if ( m_bBoxes && !IsVisible(::GetSvgBoxF(pPoints, nCount, ::GetStrokePad(stroke_paint))) ) {
+        return;
+    }
+    BeginOutput();
+    m_writer.BeginElem("polyline");
+    ::AppendPointsF(m_writer, pPoints, nCount);
+    BeginStyle();
+    m_writer.Append("fill:none;");
+    ::AppendStroke(m_writer, stroke_paint);
+    EndStyle();
+    m_writer.EndElem();
+}
+
+void SvgGDC::DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint)
+{
+    if ( m_bBoxes && !IsVisible(::GetSvgBoxF(pPoints, nCount, ::GetStrokePad(stroke_paint))) ) {
+        return;
+    }
+    BeginOutput();
+    const std::string *pPatternName = GetPattern(fill_paint); // pattern definition goes before the element
+
+    m_writer.BeginElem("polygon");
+    ::AppendPointsF(m_writer, pPoints, nCount);
+    BeginStyle();
+    AppendFill(fill_paint, pPatternName);
+    m_writer.Append(';');
+    ::AppendStroke(m_writer, stroke_paint);
+    EndStyle();
+    m_writer.EndElem();
+}
+
+// d="..." of the GDCPath: absolute M, relative l/h/v/a/q/c, repeated commands are implicit.
+// Arc of the full circle is split in two, svg arc can't start and end at the same point.
+static void AppendPathData(CSvgWriter &writer, const GDCPath &path, CSvgBox &box)
+{
+    const std::vector<uint8_t> &verbs   = path.GetVerbs();
+    const std::vector<GDCPoint> &points = path.GetPoints();
+    const std::vector<GDCPathArc> &arcs = path.GetArcs();
+    size_t iPoint = 0;
+    size_t iArc   = 0;
+
+    bool bCurrent = false;
+    int32_t x  = 0; // current point
+    int32_t y  = 0;
+    int32_t x0 = 0; // subpath start
+    int32_t y0 = 0;
+    char cCmd  = 0;
+
+    auto move_to = [&](int32_t xTo, int32_t yTo) {
+        writer.Append('M');
+        writer.Append(xTo);
+        AppendPathNumber(writer, yTo, true);
+        cCmd = 'M'; // next pairs would be absolute lines -> the relative segment always gets the letter
+        x = x0 = xTo;
+        y = y0 = yTo;
+        bCurrent = true;
+        box.Add(xTo, yTo, 0);
+    };
+    auto line_to = [&](int32_t xTo, int32_t yTo) {
+        const int32_t dx = xTo - x;
+        const int32_t dy = yTo - y;
+        const char cNext = (dy == 0) ? 'h' : (dx == 0) ? 'v' : 'l';
+        const bool bSeparate = (cNext == cCmd);
+        if ( !bSeparate ) {
+            writer.Append(cNext);
+            cCmd = cNext;
+        }
+        if ( cNext != 'v' ) {
+            AppendPathNumber(writer, dx, bSeparate);
+        }
+        if ( cNext != 'h' ) {
+            AppendPathNumber(writer, dy, bSeparate || cNext == 'l');
+        }
+        x = xTo;
+        y = yTo;
+        box.Add(xTo, yTo, 0);
+    };
+    auto arc_to = [&](int32_t nRadius, float fSweepAngle, const GDCPoint &end) {
+        const bool bSeparate = (cCmd == 'a');
+        if ( !bSeparate ) {
+            writer.Append('a');
+            cCmd = 'a';
+        }
+        AppendPathNumber(writer, nRadius, bSeparate);
+        AppendPathNumber(writer, nRadius, true);
+        writer.Append(" 0 ", 3);
+        writer.Append(::fabs(fSweepAngle) > 180.f ? '1' : '0'); // large-arc-flag
+        writer.Append(' ');
+        writer.Append(fSweepAngle > 0.f ? '0' : '1');           // sweep-flag: counter clockwise on the screen
+        AppendPathNumber(writer, end.x - x, true);
+        AppendPathNumber(writer, end.y - y, true);
+        x = end.x;
+        y = end.y;
+    };
+
+    // control points and the end point relative to the current point
+    auto curve_to = [&](char cNext, const GDCPoint *pPoints, size_t nCount) {
+        if ( !bCurrent ) {
+            move_to(pPoints[0].x, pPoints[0].y); // curve without the start point
+        }
+        const bool bSeparate = (cNext == cCmd);
+        if ( !bSeparate ) {
+            writer.Append(cNext);
+            cCmd = cNext;
+        }
+        for (size_t i = 0; i < nCount; ++i) {
+            AppendPathNumber(writer, pPoints[i].x - x, bSeparate || i > 0);
+            AppendPathNumber(writer, pPoints[i].y - y, true);
+            box.Add(pPoints[i].x, pPoints[i].y, 0);
+        }
+        x = pPoints[nCount - 1].x;
+        y = pPoints[nCount - 1].y;
+    };
+
+    for (const uint8_t verb : verbs)
+    {
+        switch ( verb )
+        {
+        case GDC_PATH_MOVE:
+            move_to(points[iPoint].x, points[iPoint].y);
+            ++iPoint;
+            break;
+        case GDC_PATH_LINE:
+            if ( bCurrent ) {
+                line_to(points[iPoint].x, points[iPoint].y);
+            }
+            else {
+                move_to(points[iPoint].x, points[iPoint].y);
+            }
+            ++iPoint;
+            break;
+        case GDC_PATH_ARC:
+            {
+                const GDCPathArc &arc = arcs[iArc++];
+                const GDCPoint start = arc.GetStart();
+                if ( !bCurrent ) {
+                    move_to(start.x, start.y);
+                }
+                else if ( start.x != x || start.y != y ) {
+                    line_to(start.x, start.y);
+                }
+                box.Add(arc.m_center.x, arc.m_center.y, arc.m_nRadius);
+                if ( arc.m_nRadius <= 0 || arc.m_fSweepAngle == 0.f ) {
+                    break;
+                }
+                const float fSweep = (std::max)(-360.f, (std::min)(360.f, arc.m_fSweepAngle));
+                if ( ::fabs(fSweep) >= 360.f ) {
+                    arc_to(arc.m_nRadius, fSweep * 0.5f, arc.GetPoint(arc.m_fStartAngle + fSweep * 0.5f));
+                    arc_to(arc.m_nRadius, fSweep * 0.5f, start);
+                }
+                else {
+                    arc_to(arc.m_nRadius, fSweep, arc.GetEnd());
+                }
+            }
+            break;
+        case GDC_PATH_QUAD:
+            curve_to('q', &points[iPoint], 2);
+            iPoint += 2;
+            break;
+        case GDC_PATH_CUBIC:
+            curve_to('c', &points[iPoint], 3);
+            iPoint += 3;
+            break;
+        case GDC_PATH_CLOSE:
+            if ( bCurrent ) {
+                writer.Append('z');
+                cCmd = 'z';
+                x = x0;
+                y = y0;
+            }
+            break;
+        default:
+            ASSERT(FALSE);
+            break;
+        }
+    }
+}
+
+// the path data is encoded with the writer and moved into the cache -> writer content is not changed
+static CSvgPath *CreateSvgPath(CSvgWriter &writer, const GDCPath &path)
+{
+    CSvgPath *pSvgPath = new CSvgPath;
+    const size_t nBegin = writer.Size();
+    ::AppendPathData(writer, path, pSvgPath->m_box);
+    pSvgPath->m_sData.assign(writer.Data() + nBegin, writer.Size() - nBegin);
+    writer.Truncate(nBegin);
+    return pSvgPath;
+}
 
-    line("<rect ", sXY.c_str(), " ", sWidth.c_str(), " ", sHeight.c_str(), " ", sStyle.c_str(), "\" />");
+void SvgGDC::DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint)
+{
+    if ( !path.m_pSvgPath ) {
+        path.m_pSvgPath = ::CreateSvgPath(m_writer, path);
+    }
+    const CSvgPath *pSvgPath = static_cast<const CSvgPath *>(path.m_pSvgPath);
+    if ( pSvgPath->m_sData.empty() ) {
+        return;
+    }
+    if ( m_bBoxes ) {
+        const CSvgBox &box = pSvgPath->m_box;
+        const int32_t nPad = pStrokePaint ? ::GetStrokePad(*pStrokePaint) : 0;
+        if ( !IsVisible(CSvgBox(box.m_nMinX, box.m_nMinY, box.m_nMaxX, box.m_nMaxY, nPad)) ) {
+            return;
+        }
+    }
+    BeginOutput();
+    const std::string *pPatternName = pFillPaint ? GetPattern(*pFillPaint) : nullptr; // pattern definition goes before the element
+
+    m_writer.BeginElem("path");
+    m_writer.BeginAttr("d");
+    m_writer.Append(pSvgPath->m_sData.data(), pSvgPath->m_sData.size());
+    m_writer.EndAttr();
+    BeginStyle();
+    if ( pFillPaint ) {
+        AppendFill(*pFillPaint, pPatternName);
+    }
+    else {
+        m_writer.Append("fill:none");
+    }
+    if ( path.GetFillRule() == GDC_FILL_RULE_EVENODD ) {
+        m_writer.Append(";fill-rule:evenodd");
+    }
+    if ( pStrokePaint ) {
+        m_writer.Append(';');
+        ::AppendStroke(m_writer, *pStrokePaint);
+    }
+    EndStyle();
+    m_writer.EndElem();
 }
 
 void SvgGDC::DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
+    if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, ::GetStrokePad(paint))) ) {
+        return;
+    }
+    BeginOutput();
+
     const int32_t radius_x = int32_t(::abs(x2 - x1) * 0.5);
     const int32_t radius_y = int32_t(::abs(y2 - y1) * 0.5);
 
     const int32_t center_x = int32_t((x1 + x2) * 0.5);
     const int32_t center_y = int32_t((y1 + y2) * 0.5);
 
-    std::string sLine = "<ellipse cx=\"";
-    sLine += std::to_string(center_x) + "\" cy=\"";
-    sLine += std::to_string(center_y) + "\" rx=\"";
-    sLine += std::to_string(radius_x) + "\" ry=\"";
-    sLine += std::to_string(radius_y) + "\"";
-    sLine += " style=\"fill:none;" + Stroke(paint);
-    sLine += "\"/>";
-    line(sLine.c_str());
+    WriteInstance(true, center_x, center_y, [&](const GDCPoint &org) {
+        m_writer.BeginElem("ellipse");
+        m_writer.Attr("cx", center_x - org.x);
+        m_writer.Attr("cy", center_y - org.y);
+        m_writer.Attr("rx", radius_x);
+        m_writer.Attr("ry", radius_y);
+        BeginStyle();
+        m_writer.Append("fill:none;");
+        ::AppendStroke(m_writer, paint);
+        EndStyle();
+    });
 }
 
-void SvgGDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) 
+void SvgGDC::DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint)
 {
+    if ( m_bBoxes && !IsVisible(CSvgBox(x1, y1, x2, y2, ::GetStrokePad(paint))) ) {
+        return;
+    }
+    BeginOutput();
+
     const int32_t radius_x = int32_t(::abs(x2-x1) * 0.5);
     const int32_t radius_y = int32_t(::abs(y2-y1) * 0.5);
 
     const int32_t center_x = int32_t((x1 + x2) * 0.5);
     const int32_t center_y = int32_t((y1 + y2) * 0.5);
 
-    const std::string sFill = FillColor(paint);
-    std::string sLine = "<ellipse cx=\"";
-    sLine += std::to_string(center_x) + "\" cy=\"";
-    sLine += std::to_string(center_y) + "\" rx=\"";
-    sLine += std::to_string(radius_x) + "\" ry=\"";
-    sLine += std::to_string(radius_y) + "\"";
-    sLine += " style="+sFill+";" + Stroke(paint);
-    sLine += "\"/>";
-    line(sLine.c_str());
+    WriteInstance(true, center_x, center_y, [&](const GDCPoint &org) {
+        m_writer.BeginElem("ellipse");
+        m_writer.Attr("cx", center_x - org.x);
+        m_writer.Attr("cy", center_y - org.y);
+        m_writer.Attr("rx", radius_x);
+        m_writer.Attr("ry", radius_y);
+        BeginStyle();
+        ::AppendFillColor(m_writer, paint);
+        m_writer.Append(';');
+        ::AppendStroke(m_writer, paint);
+        EndStyle();
+    });
 }
 
 void SvgGDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_t ry, int32_t h, const GDCPaint &fill_paint)
@@ -662,25 +1269,35 @@ void SvgGDC::DrawHollowOval(int32_t xCenter, int32_t yCenter, int32_t rx, int32_
     //ellipse.addAttribute("ry", oval.height() / 2);
 }
 
-void SvgGDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint) 
+void SvgGDC::DrawArc(int32_t x, int32_t y, const int32_t nRadius, const float fStartAngle, const float fSweepAngle, const GDCPaint &paint)
 {
+    if ( m_bBoxes && !IsVisible(CSvgBox(x, y, x, y, nRadius + ::GetStrokePad(paint))) ) {
+        return;
+    }
+    BeginOutput();
+
     const int32_t x1 = int32_t(x + nRadius * (::cos(-fStartAngle * SVG_PI / 180.0)));
     const int32_t y1 = int32_t(y + nRadius * (::sin(-fStartAngle * SVG_PI / 180.0)));
 
     const int32_t x2 = int32_t(x + nRadius * (::cos(-fSweepAngle * SVG_PI / 180.0)));
     const int32_t y2 = int32_t(y + nRadius * (::sin(-fSweepAngle * SVG_PI / 180.0)));
 
-    std::string sLine = "<path d=\"";
-    sLine += "M" + std::to_string(x) + " " + std::to_string(y);   // Move to center
-    sLine += "L" + std::to_string(x1) + " " + std::to_string(y1); // Line to first point
-    sLine += "A" + std::to_string(nRadius) + " " + std::to_string(nRadius) + " 0 0 0 " + std::to_string(x2) + " " + std::to_string(y2); // Actual Arc to point nr. 2
-    sLine += "L" + std::to_string(x) + " " + std::to_string(y);   // Move to center
-    sLine += "\"  style=\"fill:none;" + Stroke(paint);
-    sLine += "\"/>";
-    line(sLine.c_str());
-}	
+    m_writer.BeginElem("path");
+    m_writer.BeginAttr("d");
+    m_writer.Append('M'); m_writer.Append(x);  m_writer.Append(' '); m_writer.Append(y);  // Move to center
+    m_writer.Append('L'); m_writer.Append(x1); m_writer.Append(' '); m_writer.Append(y1); // Line to first point
+    m_writer.Append('A'); m_writer.Append(nRadius); m_writer.Append(' '); m_writer.Append(nRadius);
+    m_writer.Append(" 0 0 0 "); m_writer.Append(x2); m_writer.Append(' '); m_writer.Append(y2); // Actual Arc to point nr. 2
+    m_writer.Append('L'); m_writer.Append(x);  m_writer.Append(' '); m_writer.Append(y);  // Move to center
+    m_writer.EndAttr();
+    BeginStyle();
+    m_writer.Append("fill:none;");
+    ::AppendStroke(m_writer, paint);
+    EndStyle();
+    m_writer.EndElem();
+}
 
-void SvgGDC::DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y) 
+void SvgGDC::DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y)
 {
     // https://stackoverflow.com/questions/6249664/does-svg-support-embedding-of-bitmap-images
     /*
@@ -712,102 +1329,71 @@ void SvgGDC::DrawBitmap(HBITMAP hBitmap, int32_t x, int32_t y)
         imageUse.addAttribute("xlink:href", SkStringPrintf("#%s", imageID.c_str()));
     }
     */
-}   
-
-// or maybe should be used:
-// http://stackoverflow.com/questions/4358870/convert-wstring-to-string-encoded-in-utf-8
-// std::wstring_convert<std::codecvt_utf8<wchar_t>> myconv;
-// return myconv.to_bytes(str);
-static inline std::string ConvertToUTF8(const wchar_t *wstr)
-{
-    const int32_t nLen = (int32_t)wcslen(wstr);
-    if ( nLen <= 0  ) {
-        return std::string();
-    }
-
-    const auto size_needed = WideCharToMultiByte(CP_UTF8, 0, &wstr[0], nLen, NULL, 0, NULL, NULL);
-    std::string strTo(size_needed, 0);
-    ::WideCharToMultiByte(CP_UTF8, 0, &wstr[0], nLen, &strTo[0], size_needed, NULL, NULL);
-    return strTo;
 }
 
-void SvgGDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint) 
+void SvgGDC::TextOut(const wchar_t *sText, int32_t x, int32_t y, const GDCPaint &paint)
 {
+    if ( m_bBoxes && !IsVisible(CSvgBox(x, y, x, y, ::GetTextPad(sText, paint))) ) {
+        return;
+    }
+    BeginOutput();
     //int32_t angle = (int32_t)(-vector_util::CalcAngle(v) * 1800.0 / PI);
     // calculates angle clockwise from x axis to vector v
     // from -pi to pi
     // font-family
     // http://vanseodesign.com/web-design/svg-text-baseline-alignment/
-    std::string sPaint;
+    m_writer.BeginElem("text");
+    m_writer.Attr("x", x);
+    m_writer.Attr("y", y);
+
     const GDCFontDescr *pFont = paint.GetFontDescr();
     if ( pFont->m_nTextAlign & GDC_TA_BOTTOM ) {
-        sPaint += "dominant-baseline=\"text-after-edge\"";
+        m_writer.Attr("dominant-baseline", "text-after-edge");
     }
     else if ( pFont->m_nTextAlign & GDC_TA_BASELINE ) {
-        sPaint += "alignment-baseline=\"baseline\"";
+        m_writer.Attr("alignment-baseline", "baseline");
     }
     else if ( pFont->m_nTextAlign & GDC_TA_TOP ) {
-        sPaint += "dominant-baseline=\"text-before-edge\"";
+        m_writer.Attr("dominant-baseline", "text-before-edge");
     }
-    sPaint += " ";
     if ( pFont->m_nTextAlign & GDC_TA_LEFT ) {
-        sPaint += "text-anchor=\"start\"";
+        m_writer.Attr("text-anchor", "start");
     }
     else if ( pFont->m_nTextAlign & GDC_TA_CENTER ) {
-        sPaint += "text-anchor=\"middle\"";
+        m_writer.Attr("text-anchor", "middle");
     }
     else if ( pFont->m_nTextAlign & GDC_TA_RIGHT ) {
-        sPaint += "text-anchor=\"end\"";
+        m_writer.Attr("text-anchor", "end");
     }
     GDCFontWeight weight = pFont->m_weight;
     if ( weight <= 0 ) {
-        weight = GDC_FW_NORMAL; // chromium does not like 0 
-    }
-    sPaint += " ";
-    sPaint += "font-weight=\"";
-    sPaint += std::to_string(weight);
-    sPaint += "\" ";                  
-    sPaint += "font-size=\"";
-    sPaint += std::to_string(::abs(pFont->m_nHeight));
-    sPaint += "\" ";       
-    {
-        {
-            std::string sColor = PaintColorToString(paint);
-            std::string sStyle = "style=\"";
-                        sStyle += "font-family:";
-                        sStyle += ConvertToUTF8(pFont->m_sFontName.c_str());
-                        sStyle += ";";
-                        sStyle += "fill:";
-                        sStyle += sColor.c_str();
-                        //sStyle += ";";
-                        //sStyle += ";";
-                        sStyle += "\"";
-            sPaint  += sStyle;
-        }
-        {
-            float fAngle = pFont->m_fAngle;
-            fAngle = float((-1)*fAngle/10.);
-            std::string sAngle = float_to_string(fAngle);
-            // The rotate(<a> [<x> <y>]) transform function specifies a rotation by a degrees about a given point. 
-            // If optional parameters x and y are not supplied, the rotation is about the origin of the current user coordinate system. 
-            // If optional parameters x and y are supplied, the rotate is about the point (x, y).
-            std::string sTransform  = "transform=\"rotate(";
-                        sTransform += sAngle;
-                        sTransform += ",";
-                        sTransform += std::to_string(x);
-                        sTransform += ",";
-                        sTransform += std::to_string(y);
-                        sTransform += ")\"";
-            sPaint += " ";
-            sPaint += sTransform;
-        }
+        weight = GDC_FW_NORMAL; // chromium does not like 0
     }
-
-    const std::string sTextUTF8 = ConvertToUTF8(sText);
-
-    line("<text x=\"", std::to_string(x).c_str(),
-            "\" y=\"", std::to_string(y).c_str(), 
-            "\" ", sPaint.c_str(), ">", sTextUTF8.c_str(), "</text>");
+    m_writer.Attr("font-weight", (int32_t)weight);
+    m_writer.Attr("font-size", (int32_t)::abs(pFont->m_nHeight));
+
+    BeginStyle();
+    m_writer.Append("font-family:");
+    m_writer.AppendUTF8(pFont->m_sFontName.c_str());
+    m_writer.Append(';');
+    ::AppendFillColor(m_writer, paint);
+    EndStyle();
+
+    // The rotate(<a> [<x> <y>]) transform function specifies a rotation by a degrees about a given point.
+    // If optional parameters x and y are not supplied, the rotation is about the origin of the current user coordinate system.
+    // If optional parameters x and y are supplied, the rotate is about the point (x, y).
+    const float fAngle = float((-1)*pFont->m_fAngle/10.);
+    m_writer.BeginAttr("transform");
+    m_writer.Append("rotate(");
+    m_writer.Append(fAngle);
+    m_writer.Append(',');
+    m_writer.AppendPoint(x, y);
+    m_writer.Append(')');
+    m_writer.EndAttr();
+
+    m_writer.Append('>');
+    m_writer.AppendUTF8(sText);
+    m_writer.CloseElem("text");
 }
 
 void SvgGDC::DrawText(const wchar_t *sText, const RECT &rect, const GDCPaint &paint)
@@ -831,45 +1417,79 @@ GDCSize SvgGDC::GetTextExtent(const wchar_t *sText, size_t nCount, const GDCPain
     return gdc.GetTextExtent(sText, paint);
 }
 
-void SvgGDC::SetViewportOrg(int32_t x, int32_t y) 
+void SvgGDC::SetViewportOrg(int32_t x, int32_t y)
 {
-    std::string sWidth  = std::to_string(m_nWidth);
-    std::string sHeight = std::to_string(m_nHeight);
-
-    std::string sViewBox  = "viewbox=\"";
-                sViewBox += std::to_string(-x);
-                sViewBox += " ";
-                sViewBox += std::to_string(-y);
-                sViewBox += " ";
-                sViewBox += sWidth;
-                sViewBox += " ";
-                sViewBox += sHeight;
-                sViewBox += "\"";
+    FlushLineRun(); // open <path> of the merged lines is not split by the root element
+    m_view = CSvgBox(-x, -y, -x + m_nWidth, -y + m_nHeight, 0);
+    if ( m_pContent ) {
+        m_xOrg = x;
+        m_yOrg = y;
+        m_bRootPending = true;
+        return;
+    }
+    WriteRoot(x, y);
+}
 
+void SvgGDC::WriteRoot(int32_t x, int32_t y)
+{
+    m_writer.BeginElem("svg");
     // https://developer.mozilla.org/en-US/docs/Web/SVG/Attribute/shape-rendering
     // *auto
-    // Indicates that the user agent shall make appropriate tradeoffs to balance speed, crisp edges and geometric precision, 
+    // Indicates that the user agent shall make appropriate tradeoffs to balance speed, crisp edges and geometric precision,
     // but with geometric precision given more importance than speed and crisp edges.
     // *optimizeSpeed
-    // Indicates that the user agent shall emphasize rendering speed over geometric precision and crisp edges. 
+    // Indicates that the user agent shall emphasize rendering speed over geometric precision and crisp edges.
     // This option will sometimes cause the user agent to turn off shape anti-aliasing.
     // *crispEdges
-    // Indicates that the user agent shall attempt to emphasize the contrast between clean edges of artwork over rendering speed and geometric precision. 
-    // To achieve crisp edges, the user agent might turn off anti-aliasing for all lines and curves or possibly just for straight lines which are close 
+    // Indicates that the user agent shall attempt to emphasize the contrast between clean edges of artwork over rendering speed and geometric precision.
+    // To achieve crisp edges, the user agent might turn off anti-aliasing for all lines and curves or possibly just for straight lines which are close
     // to vertical or horizontal. Also, the user agent might adjust line positions and line widths to align edges with device pixels.
     // *geometricPrecision
     // Indicates that the user agent shall emphasize geometric precision over speed and crisp edges.
-    if ( m_bAutoSize )
-    {
-        sWidth  = "100%";
-        sHeight = "100%";
-        line("<svg width=\"", sWidth.c_str(), "\" height=\"", sHeight.c_str(), "\" ", sViewBox.c_str(), " shape-rendering=\"geometricPrecision\" xmlns=\"http://www.w3.org/2000/svg\">");
+    if ( m_bAutoSize ) {
+        m_writer.Attr("width",  "100%");
+        m_writer.Attr("height", "100%");
+    }
+    else {
+        m_writer.Attr("width",  m_nWidth);
+        m_writer.Attr("height", m_nHeight);
+    }
+
+    m_writer.BeginAttr("viewBox");
+    if ( m_bFitViewBox && !m_extents.IsEmpty() ) {
+        m_writer.Append(m_extents.m_nMinX);
+        m_writer.Append(' ');
+        m_writer.Append(m_extents.m_nMinY);
+        m_writer.Append(' ');
+        m_writer.Append(m_extents.m_nMaxX - m_extents.m_nMinX);
+        m_writer.Append(' ');
+        m_writer.Append(m_extents.m_nMaxY - m_extents.m_nMinY);
+    }
+    else {
+        m_writer.Append(-x);
+        m_writer.Append(' ');
+        m_writer.Append(-y);
+        m_writer.Append(' ');
+        m_writer.Append(m_nWidth);
+        m_writer.Append(' ');
+        m_writer.Append(m_nHeight);
+    }
+    m_writer.EndAttr();
+
+    if ( m_bAutoSize ) {
+        m_writer.Attr("shape-rendering", "geometricPrecision");
     }
     else {
         // quality a bit better vs. geometricPrecision
-        line("<svg width=\"", sWidth.c_str(), "\" height=\"", sHeight.c_str(), "\" ", sViewBox.c_str(), " shape-rendering=\"crispEdges\" xmlns=\"http://www.w3.org/2000/svg\">");
+        m_writer.Attr("shape-rendering", "crispEdges");
+    }
+    m_writer.Attr("xmlns", "http://www.w3.org/2000/svg");
+    if ( m_bInstancing ) {
+        m_writer.Attr("xmlns:xlink", "http://www.w3.org/1999/xlink");
     }
-    
+    m_writer.Append(">\n", 2);
+    m_writer.Flush();
+
     // special case for the cromium engine: staticly types invert filter to have at least possibility to hilight elements
     // https://stackoverflow.com/questions/32567156/why-dont-css-filters-work-on-svg-elements-in-chrome
     // workaround:
@@ -882,8 +1502,8 @@ void SvgGDC::SetViewportOrg(int32_t x, int32_t y)
     // this code can be added into the html page as additional svg item if selction required
 }
 
-GDCPoint SvgGDC::GetViewportOrg() const 
-{ 
+GDCPoint SvgGDC::GetViewportOrg() const
+{
     return GDCPoint(0, 0);
 }
 
@@ -891,22 +1511,35 @@ HDC SvgGDC::GetHDC() { return nullptr; }
 
 void SvgGDC::BeginGroup(const char *sGroupAttributes)
 {
-     line("<g ", sGroupAttributes, ">");
+    FlushLineRun();
+    if ( m_bCulling ) {
+        m_pending_groups.emplace_back(sGroupAttributes); // empty group is not written
+        return;
+    }
+    m_writer.Append("<g ", 3);
+    m_writer.Append(sGroupAttributes);
+    m_writer.Append(">\n", 2);
+    m_writer.Flush();
 }
 
 void SvgGDC::EndGroup()
 {
-    line("</g>");
+    FlushLineRun();
+    if ( !m_pending_groups.empty() ) {
+        m_pending_groups.pop_back();
+        return;
+    }
+    m_writer.Line("</g>");
 }
 
-void SvgGDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter, 
+void SvgGDC::DrawTextByEllipse(double dCenterAngle, int32_t nRadiusX, int32_t nRadiusY, int32_t xCenter, int32_t yCenter,
                                const wchar_t *sText, double dEllipseAngleRad, const GDCPaint &paint)
 {
     //TODO
 }
 
-void SvgGDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText, 
+void SvgGDC::DrawTextByCircle(double dCenterAngle, int32_t nRadius, int32_t nCX, int32_t nCY, const wchar_t *sText,
                               bool bRevertTextDir, const GDCPaint &paint)
 {
     //TODO
-}
\ No newline at end of file
+}
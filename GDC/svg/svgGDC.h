@@ -6,17 +6,35 @@
     #include "../AbsGDC.h"
 #endif
 
+#ifndef __SVG_WRITER_H__
+    #include "SvgWriter.h"
+#endif
+
+#ifndef __SVG_RESOURCE_IDS_H__
+    #include "SvgResourceIds.h"
+#endif
+
+#ifndef __SVG_BOX_H__
+    #include "SvgBox.h"
+#endif
+
 #include "unordered_map"
+#include "string"
+#include "string_view"
+#include "deque"
+#include "algorithm"
 
 class CSvgFileAbs;
+class CSvgChunkBuffer;
+class GDCSvg;
+class GDCSvgStats;
 
 class SvgGDC final : public CAbsGDC
 {
 // Construction/Destruction
 public:
-    // sPrefix - can be empty -> must be used to make svg image id's unique
-    SvgGDC(const wchar_t *sFilePath, int32_t nWidth, int32_t nHeight, bool bAutoSize, const char *sPrefix);
-    SvgGDC(std::string *pBuffer, int32_t nWidth, int32_t nHeight, bool bAutoSize, const char *sPrefix);
+    // svg prefix - can be empty -> must be used to make svg image id's unique
+    SvgGDC(GDCSvg &svg);
     virtual ~SvgGDC();
 
 // Overrides
@@ -24,18 +42,26 @@ public:
     virtual void DrawLine(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
     virtual void DrawPoint(int32_t x, int32_t y, const GDCPaint &paint) override;
     
-    virtual void DrawPolygon(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
-    virtual void DrawPoly(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) override; // closed line => polygon
-    virtual void DrawPolyLine(const std::vector<GDCPoint> &points, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygon(const GDCPoints &points, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoly(const GDCPoints &points, const GDCPaint &stroke_paint) override; // closed line => polygon
+    virtual void DrawPolyLine(const GDCPoints &points, const GDCPaint &stroke_paint) override;
     
-    virtual void DrawPolygonTransparent(const std::vector<GDCPoint> &points, const GDCPaint &fill_paint) override;
-    virtual void DrawPolygonGradient(const std::vector<GDCPoint> &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
+    virtual void DrawPolygonTransparent(const GDCPoints &points, const GDCPaint &fill_paint) override;
+    virtual void DrawPolygonGradient(const GDCPoints &points, const GDCPaint &paintFrom, const GDCPaint &paintTo) override;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const wchar_t * sTexturePath, double dAngle, float fZoom) override;
     virtual void DrawPolygonTexture(const std::vector<GDCPoint> &points, const std::vector<GDCPoint> &points_exclude, 
                                     const wchar_t *sTexturePath, double dAngle, float fZoom) override;
 
     virtual void DrawFilledRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &fill_paint) override;
     virtual void DrawRectangle(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
+
+    virtual void DrawLines(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawRects(const GDCPoints &corners, const GDCPaint &stroke_paint) override;
+    virtual void DrawPoints(const GDCPoints &points, const GDCPaint &paint) override;
+    virtual void DrawLineF(float x1, float y1, float x2, float y2, const GDCPaint &paint) override;
+    virtual void DrawPolyLineF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &stroke_paint) override;
+    virtual void DrawPolygonF(const GDCPointF *pPoints, size_t nCount, const GDCPaint &fill_paint, const GDCPaint &stroke_paint) override;
+    virtual void DrawPath(const GDCPath &path, const GDCPaint *pFillPaint, const GDCPaint *pStrokePaint) override;
     
     virtual void DrawEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
     virtual void DrawFilledEllipse(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint) override;
@@ -59,36 +85,93 @@ public:
     virtual void SetViewportOrg(int32_t x, int32_t y) override;
     virtual GDCPoint GetViewportOrg() const override;
 
+    virtual void SetCurveTolerance(float fTolerance) override { } // curves are written as is
+
     virtual HDC GetHDC() override; // platform specific (must be used only for the transitional code)
 
     virtual void BeginGroup(const char *sGroupAttributes) override;
     virtual void EndGroup() override; 
 
 private:
-    const char *enter_elem() const { return "\n"; }
-    void line(const char *val1);
-    void line(const char *val1, const char *val2, const char *val3);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, const char *val7);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, const char *val7, const char *val8);
-    void line(const char *val1, const char *val2, const char *val3, const char *val4, const char *val5, const char *val6, const char *val7, const char *val8, const char *val9);
+    static CSvgFileAbs *CreateSvgFile(GDCSvg &svg);
+    const std::string *GetPattern(const GDCPaint &fill_paint);
+    void AppendFill(const GDCPaint &fill_paint, const std::string *pPatternName);
+    void BeginStyle();
+    void EndStyle();
+    void WriteStyleClasses();
+    void WriteRoot(int32_t x, int32_t y);
+    void WriteDefs(const std::string &sDef);
+    void WriteDeferredHeader();
 
-private:
-    std::string GetPattern(const GDCPaint &fill_paint);
-    std::string GetFill(const GDCPaint &fill_paint);
+    // WriteElem(org) writes the element relative to the org without the end
+    template <class TWriteElem>
+    void WriteInstance(bool bInstance, int32_t x, int32_t y, const TWriteElem &WriteElem);
+    bool WriteUse(size_t nElemBegin, int32_t x, int32_t y);
+
+    void AppendLineRun(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const GDCPaint &paint);
+    void EndLineRun();
+    // pending line run must be written before any other output
+    void FlushLineRun() {
+        if ( m_bLineRun ) {
+            EndLineRun();
+        }
+    }
+
+    // batch is the one <path d="..."> opened by the first visible primitive
+    void BeginBatch(const GDCPaint &paint, bool bPoints);
+    void EndBatch();
+
+    // m_bBoxes: culling and the drawn extents
+    bool IsVisible(const CSvgBox &box);
+    // pending line run and groups go before the element
+    void BeginOutput() {
+        FlushLineRun();
+        OpenGroups();
+    }
+    void OpenGroups();
     
 // Attributes
 private:
     CSvgFileAbs *m_pFile {nullptr};
+    CSvgChunkBuffer *m_pContent {nullptr}; // deferred header: content is collected here
+    CSvgWriter m_writer;
     int32_t m_nWidth; 
     int32_t m_nHeight;
     bool m_bAutoSize {false};
 
-    std::unordered_map<std::string, std::string> m_horizontal_grads;
-    std::vector<std::string> m_patterns;
+    CSvgResourceIds m_horizontal_grads; // (color from, color to) -> gradient id
+    CSvgResourceIds m_patterns;         // (paint type, color) -> pattern id
     std::string m_sPrefix;
+
+    bool m_bStyleClasses {false};
+    size_t m_nStyleAttr  {0};
+    size_t m_nStyleBegin {0};
+    std::deque<std::string> m_styles; // class id -> style, deque: keys of the m_style_classes must stay valid
+    std::unordered_map<std::string_view, int32_t> m_style_classes;
+
+    bool m_bFitViewBox {false};
+    bool m_bRootPending {false};
+    int32_t m_xOrg {0};
+    int32_t m_yOrg {0};
+    std::string m_defs; // deferred header: definitions go into the single <defs>
+    CSvgBox m_extents;
+
+    bool m_bMergeLines {false};
+    bool m_bLineRun {false};
+    COLORREF m_run_color {0};
+    float m_fRunWidth {0.f};
+    int32_t m_nRunStrokeType {0}; // GDCStrokeType
+
+    bool m_bInstancing {false};
+    int32_t m_nSymbols {0};
+    std::deque<std::string> m_instance_elems; // elements relative to the org, deque: keys of the m_instances must stay valid
+    std::unordered_map<std::string_view, int32_t> m_instances; // element -> symbol id, -1: element is written once
+
+    GDCSvgStats *m_pStats;
+    bool m_bBoxes {false};
+    bool m_bCulling {false};
+    CSvgBox m_view;                           // culling: visible rectangle
+    std::vector<std::string> m_pending_groups; // culling: groups are written with the first visible element
 };
 
 #endif
\ No newline at end of file